@@ -6,6 +6,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <memory>
 
 #include "Clause.hpp"
 #include "util/exception.hpp"
@@ -13,77 +14,145 @@
 namespace sat {
     //TODO implementation here
 
-    Clause::Clause(std::vector<Literal> literals) : literals(std::move(literals)) {
-        // Initialize watchers (watch literals)
-        if (this->literals.empty()) {
-            watcherIdx0 = 0;
-            watcherIdx1 = 0;
-        } else if (this->literals.size() == 1) {
-            watcherIdx0 = 0;
-            watcherIdx1 = 0; 
+    // watchers are the literals at position 0 and 1
+    Clause::Clause() : heapLiterals(nullptr) {}
+
+    Clause::Clause(std::vector<Literal> literals) : Clause(std::span<const Literal>(literals)) {}
+
+    Clause::Clause(std::span<const Literal> literals) : heapLiterals(nullptr) {
+        assign(literals);
+    }
+
+    Clause::Clause(const Clause &other) : heapLiterals(nullptr) {
+        assign(std::span(other.begin(), other.end()));
+    }
+
+    Clause::Clause(Clause &&other) noexcept : heapLiterals(nullptr) {
+        *this = std::move(other);
+    }
+
+    Clause &Clause::operator=(const Clause &other) {
+        if (this != &other) {
+            release();
+            assign(std::span(other.begin(), other.end()));
+        }
+
+        return *this;
+    }
+
+    Clause &Clause::operator=(Clause &&other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+
+        release();
+        if (other.isInline()) {
+            assign(std::span(other.begin(), other.end()));
         } else {
-            watcherIdx0 = 0;
-            watcherIdx1 = 1;
+            // takes over the heap storage
+            numLiterals = other.numLiterals;
+            heapLiterals = other.heapLiterals;
+            other.numLiterals = 0;
+        }
+
+        return *this;
+    }
+
+    Clause::~Clause() {
+        release();
+    }
+
+    bool Clause::isInline() const {
+        return numLiterals <= InlineCapacity;
+    }
+
+    const Literal *Clause::data() const {
+        return isInline() ? inlineLiterals : heapLiterals;
+    }
+
+    Literal *Clause::data() {
+        return isInline() ? inlineLiterals : heapLiterals;
+    }
+
+    void Clause::assign(std::span<const Literal> literals) {
+        assert(isInline());
+        numLiterals = static_cast<std::uint32_t>(literals.size());
+        if (!isInline()) {
+            heapLiterals = std::allocator<Literal>().allocate(literals.size());
+        }
+
+        std::uninitialized_copy(literals.begin(), literals.end(), data());
+    }
+
+    void Clause::release() {
+        if (!isInline()) {
+            std::allocator<Literal>().deallocate(heapLiterals, numLiterals);
         }
+
+        numLiterals = 0;
     }
 
     short Clause::getRank(Literal l) const {
-        if (literals.empty()) return -1;
+        if (numLiterals == 0) return -1;
 
-        if (literals[watcherIdx0] == l) return 0;
-        if (literals[watcherIdx1] == l) return 1;
+        if (data()[0] == l) return 0;
+        if (numLiterals > 1 && data()[1] == l) return 1;
         return -1;
     }
 
     std::size_t Clause::getIndex(short rank) const {
         // rank: 0 -> first watcher, otherwise -> second watcher
-        return (rank == 0) ? watcherIdx0 : watcherIdx1;
+        return (rank == 0 || numLiterals < 2) ? 0 : 1;
     }
 
     bool Clause::setWatcher(Literal l, short watcherNo) {
         // watcherNo should be 0 or 1
         assert(watcherNo == 0 || watcherNo == 1);
 
-        auto it = std::find(literals.begin(), literals.end(), l);
-        if (it == literals.end()) return false;
+        Literal *lits = data();
+        auto it = std::find(lits, lits + numLiterals, l);
+        if (it == lits + numLiterals) return false;
 
-        std::size_t idx = static_cast<std::size_t>(std::distance(literals.begin(), it));
-        if (watcherNo == 0) watcherIdx0 = idx;
-        else watcherIdx1 = idx;
+        std::iter_swap(it, lits + getIndex(watcherNo));
         return true;
     }
 
-    auto Clause::begin() const -> std::vector<Literal>::const_iterator {
-        return literals.begin();
+    auto Clause::begin() const -> const Literal * {
+        return data();
     }
 
-    auto Clause::end() const -> std::vector<Literal>::const_iterator {
-        return literals.end();
+    auto Clause::end() const -> const Literal * {
+        return data() + numLiterals;
     }
 
     bool Clause::isEmpty() const {
-        return literals.empty();
+        return numLiterals == 0;
     }
 
     Literal Clause::operator[](std::size_t index) const {
-        assert(index < literals.size());
-        return literals[index];
+        assert(index < numLiterals);
+        return data()[index];
     }
 
     std::size_t Clause::size() const {
-        return literals.size();
+        return numLiterals;
     }
 
     Literal Clause::getWatcherByRank(short rank) const {
-        assert(!literals.empty());
-        return literals[getIndex(rank)];
+        assert(numLiterals > 0);
+        return data()[getIndex(rank)];
     }
 
     bool Clause::sameLiterals(const Clause &other) const {
-        if (literals.size() != other.literals.size()) return false;
+        if (numLiterals != other.numLiterals) return false;
 
-        std::vector<Literal> a = literals;
-        std::vector<Literal> b = other.literals;
+        // the quadratic check avoids sorting copies of short clauses
+        if (isInline()) {
+            return std::is_permutation(begin(), end(), other.begin());
+        }
+
+        std::vector<Literal> a(begin(), end());
+        std::vector<Literal> b(other.begin(), other.end());
 
         auto cmp = [](Literal x, Literal y) {
             return x.get() < y.get();
@@ -91,11 +160,7 @@ namespace sat {
 
         std::sort(a.begin(), a.end(), cmp);
         std::sort(b.begin(), b.end(), cmp);
-
-        for (std::size_t i = 0; i < a.size(); ++i) {
-            if (!(a[i] == b[i])) return false;
-        }
-        return true;
+        return a == b;
     }
 
 }
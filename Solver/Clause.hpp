@@ -9,6 +9,8 @@
 #define CLAUSE_HPP
 
 #include <vector>
+#include <span>
+#include <cstdint>
 #include <ostream>
 
 #include "util/concepts.hpp"
@@ -32,18 +34,45 @@ namespace sat {
      * the begin() and end() member functions. I recommend that you store the Literals in a private member of type
      * std::vector<Literal>. Then, to implement begin() and end(), you can simply return the iterators returned from
      * std::vector<Literal>::begin() and end() respectively
+     *
+     * The watch literals are always the first two literals of the clause (both watchers are the single literal of a
+     * unit clause). Setting a watcher swaps the new watch literal into its position, so the order of the literals
+     * changes
+     *
+     * Clauses with up to InlineCapacity literals are stored inside the object, the buffer overlaps the pointer to
+     * the heap storage of longer clauses. A clause is thereby not larger than a std::vector
      */
     class Clause {
-        std::vector<Literal> literals;
-        std::size_t watcherIdx0 = 0;
-        std::size_t watcherIdx1 = 0;
+    public:
+        static constexpr std::size_t InlineCapacity = 4;
+
+    private:
+        std::uint32_t numLiterals = 0;
+        union {
+            Literal inlineLiterals[InlineCapacity]; ///< active if numLiterals <= InlineCapacity
+            Literal *heapLiterals; ///< active otherwise, owns numLiterals literals
+        };
+
+        bool isInline() const;
+        const Literal *data() const;
+        Literal *data();
+
+        /**
+         * Copies the literals into the storage of the clause. The clause must not own heap storage
+         */
+        void assign(std::span<const Literal> literals);
+
+        /**
+         * Frees the heap storage and empties the clause
+         */
+        void release();
 
     public:
 
         /**
          * Default CTor. If you want, you can remove it or adapt it to your needs
          */
-        Clause() = default;
+        Clause();
 
         /**
          * CTor
@@ -54,6 +83,22 @@ namespace sat {
          */
         Clause(std::vector<Literal> literals);
 
+        /**
+         * CTor. Copies the literals, does not allocate for short clauses
+         * @param literals list of literals of the clause
+         */
+        Clause(std::span<const Literal> literals);
+
+        Clause(const Clause &other);
+
+        Clause(Clause &&other) noexcept;
+
+        Clause &operator=(const Clause &other);
+
+        Clause &operator=(Clause &&other) noexcept;
+
+        ~Clause();
+
         /*
          * @TODO if you want, you can declare additional constructors here
          */
@@ -69,12 +114,12 @@ namespace sat {
         /**
          * Gets the index of the watcher with the given rank
          * @param rank rank of the watcher
-         * @return first watcher index if rank is 0, second watcher index otherwise
+         * @return 0 if rank is 0, 1 otherwise (0 for unit clauses)
          */
         std::size_t getIndex(short rank) const;
 
         /**
-         * Sets the given literal as watcher
+         * Sets the given literal as watcher by swapping it with the watcher to be replaced
          * @param l Literal to be the new watcher
          * @param watcherNo number of the watcher to be replaced
          * @return true if setting watcher was successful, false if literal is not contained in clause
@@ -102,15 +147,13 @@ namespace sat {
          * Iterator to first Literal in the clause
          * @return
          */
-         auto begin() const -> std::vector<Literal>::const_iterator;
-         // change if necessary ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+         auto begin() const -> const Literal *;
 
         /**
          * Past-the-end iterator
          * @return
          */
-         auto end() const -> std::vector<Literal>::const_iterator;
-         // change if necessary ^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^^
+         auto end() const -> const Literal *;
 
         /**
          * Array subscript operator
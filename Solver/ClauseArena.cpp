@@ -0,0 +1,90 @@
+/**
+* @date 16.10.26
+* @brief
+*/
+
+#include <cassert>
+#include <stdexcept>
+
+#include "ClauseArena.hpp"
+
+namespace sat {
+
+    unsigned ClauseArena::header(ClauseRef c, std::size_t offset) const {
+        return memory[c + offset].get();
+    }
+
+    void ClauseArena::setHeader(ClauseRef c, std::size_t offset, unsigned value) {
+        memory[c + offset] = Literal(value);
+    }
+
+    ClauseRef ClauseArena::allocate(std::span<const Literal> literals, bool learnt) {
+        assert(!literals.empty());
+        // larger references would collide with the tag bit of binary reasons
+        if (memory.size() + HeaderSize + literals.size() > MaxRef) {
+            throw std::length_error("clause arena exceeds the 32-bit reference range");
+        }
+
+        const auto c = static_cast<ClauseRef>(memory.size());
+        memory.emplace_back(static_cast<unsigned>(literals.size()));
+        memory.emplace_back(learnt ? Learnt : 0u);
+        memory.insert(memory.end(), literals.begin(), literals.end());
+        return c;
+    }
+
+    void ClauseArena::free(ClauseRef c) {
+        assert(!isDeleted(c));
+        setHeader(c, FlagsOffset, header(c, FlagsOffset) | Deleted);
+        wasted += HeaderSize + size(c);
+    }
+
+    ClauseRef ClauseArena::relocate(ClauseRef c, ClauseArena &to) {
+        const unsigned flags = header(c, FlagsOffset);
+        if (flags & Deleted) {
+            return NoClause;
+        }
+
+        if (flags & Relocated) {
+            return header(c, ForwardOffset);
+        }
+
+        const auto target = static_cast<ClauseRef>(to.memory.size());
+        const auto begin = memory.begin() + static_cast<std::ptrdiff_t>(c);
+        to.memory.insert(to.memory.end(), begin, begin + static_cast<std::ptrdiff_t>(HeaderSize + size(c)));
+        setHeader(c, FlagsOffset, flags | Relocated);
+        setHeader(c, ForwardOffset, target);
+        return target;
+    }
+
+    std::span<const Literal> ClauseArena::literals(ClauseRef c) const {
+        return std::span(memory).subspan(c + HeaderSize, size(c));
+    }
+
+    std::span<Literal> ClauseArena::literals(ClauseRef c) {
+        return std::span(memory).subspan(c + HeaderSize, size(c));
+    }
+
+    std::size_t ClauseArena::size(ClauseRef c) const {
+        return header(c, SizeOffset);
+    }
+
+    bool ClauseArena::isLearnt(ClauseRef c) const {
+        return header(c, FlagsOffset) & Learnt;
+    }
+
+    bool ClauseArena::isDeleted(ClauseRef c) const {
+        return header(c, FlagsOffset) & Deleted;
+    }
+
+    std::size_t ClauseArena::capacity() const {
+        return memory.size();
+    }
+
+    std::size_t ClauseArena::garbage() const {
+        return wasted;
+    }
+
+    void ClauseArena::reserve(std::size_t words) {
+        memory.reserve(words);
+    }
+}
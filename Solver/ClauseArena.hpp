@@ -0,0 +1,119 @@
+/**
+* @date 16.10.26
+* @file ClauseArena.hpp
+* @brief Contains the clause arena that stores all clauses of the solver in one contiguous memory block
+*/
+
+#ifndef CLAUSEARENA_HPP
+#define CLAUSEARENA_HPP
+
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <limits>
+
+#include "basic_structures.hpp"
+
+namespace sat {
+
+    /**
+     * Reference to a clause in a ClauseArena (offset of the clause header)
+     */
+    using ClauseRef = std::uint32_t;
+
+    /**
+     * Invalid clause reference (e.g. reason of a decision)
+     */
+    inline constexpr ClauseRef NoClause = std::numeric_limits<ClauseRef>::max();
+
+    /**
+     * @brief Contiguous clause storage
+     * @details
+     * Every clause occupies HeaderSize + size consecutive words: size and flags, followed by the literals. Header words
+     * are stored as raw Literal values. The watch literals of a clause are its first two literals, the solver swaps new
+     * watchers into these positions. Clauses are referenced by the offset of their header (32 bit). Freed clauses stay
+     * in memory until the arena is compacted by relocating all live clauses into a new arena (see relocate).
+     */
+    class ClauseArena {
+        std::vector<Literal> memory;
+        std::size_t wasted = 0;
+
+        enum Flags : unsigned {
+            Learnt = 1,
+            Deleted = 2,
+            Relocated = 4
+        };
+
+        static constexpr std::size_t SizeOffset = 0;
+        static constexpr std::size_t FlagsOffset = 1;
+        static constexpr std::size_t ForwardOffset = 2; ///< new reference of a relocated clause (first literal)
+
+        unsigned header(ClauseRef c, std::size_t offset) const;
+        void setHeader(ClauseRef c, std::size_t offset, unsigned value);
+
+    public:
+        static constexpr std::size_t HeaderSize = 2;
+
+        /**
+         * Largest clause reference. The arena only uses the lower half of the reference range, so that the upper bit
+         * is free for tagged encodings (see Solver::BinaryTag)
+         */
+        static constexpr ClauseRef MaxRef = (ClauseRef(1) << 31) - 1;
+
+        /**
+         * Stores a clause in the arena
+         * @param literals literals of the clause (at least one)
+         * @param learnt whether the clause is a learned clause
+         * @return reference to the new clause
+         * @throws std::length_error if the arena would grow beyond MaxRef words
+         */
+        ClauseRef allocate(std::span<const Literal> literals, bool learnt = false);
+
+        /**
+         * Marks a clause as deleted. Its memory is reclaimed by the next compaction
+         * @param c clause reference
+         */
+        void free(ClauseRef c);
+
+        /**
+         * Moves a clause into another arena. The first call stores the new reference in the old header, subsequent
+         * calls return it, so that all references to a clause can be relocated one after the other
+         * @param c clause reference in this arena
+         * @param to target arena
+         * @return reference in the target arena, NoClause if the clause is deleted
+         */
+        ClauseRef relocate(ClauseRef c, ClauseArena &to);
+
+        /**
+         * Literals of the clause
+         * @param c clause reference
+         */
+        std::span<const Literal> literals(ClauseRef c) const;
+
+        /**
+         * Literals of the clause, may be reordered (e.g. to swap a new watcher into place)
+         * @param c clause reference
+         */
+        std::span<Literal> literals(ClauseRef c);
+
+        std::size_t size(ClauseRef c) const;
+
+        bool isLearnt(ClauseRef c) const;
+
+        bool isDeleted(ClauseRef c) const;
+
+        /**
+         * Number of words in use (including freed clauses)
+         */
+        std::size_t capacity() const;
+
+        /**
+         * Number of words occupied by freed clauses
+         */
+        std::size_t garbage() const;
+
+        void reserve(std::size_t words);
+    };
+}
+
+#endif //CLAUSEARENA_HPP
@@ -0,0 +1,247 @@
+/**
+* @date 16.10.26
+* @brief
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "LocalSearch.hpp"
+#include "util/random.hpp"
+
+namespace sat {
+
+    LocalSearch::LocalSearch(std::size_t numVariables, LocalSearchAlgorithm algorithm)
+        : numVariables(numVariables), algorithm(algorithm), occurrences(2 * numVariables),
+          assignment(numVariables, 0), best(numVariables, 0), initial(numVariables, 2),
+          breakCount(numVariables, 0) {}
+
+    void LocalSearch::addClause(std::span<const Literal> clause) {
+        std::vector<Literal> lits;
+        lits.reserve(clause.size());
+        for (Literal l : clause) {
+            if (std::ranges::find(lits, l.negate()) != lits.end()) {
+                return; // tautology
+            }
+
+            if (std::ranges::find(lits, l) == lits.end()) {
+                lits.emplace_back(l);
+            }
+        }
+
+        const auto idx = static_cast<std::uint32_t>(clauses.size());
+        for (Literal l : lits) {
+            occurrences[l.get()].emplace_back(idx);
+        }
+
+        clauses.emplace_back(std::move(lits));
+    }
+
+    void LocalSearch::setInitialPhases(std::span<const Literal> phases) {
+        std::ranges::fill(initial, 2);
+        for (Literal l : phases) {
+            initial[var(l).get()] = l.sign() > 0;
+        }
+    }
+
+    bool LocalSearch::isTrue(Literal l) const {
+        return assignment[var(l).get()] == (l.sign() > 0);
+    }
+
+    void LocalSearch::makeUnsat(std::uint32_t c) {
+        unsatPos[c] = static_cast<std::uint32_t>(unsat.size());
+        unsat.emplace_back(c);
+    }
+
+    void LocalSearch::makeSat(std::uint32_t c) {
+        // swap with the last element: O(1) removal
+        const std::uint32_t last = unsat.back();
+        unsat[unsatPos[c]] = last;
+        unsatPos[last] = unsatPos[c];
+        unsat.pop_back();
+    }
+
+    void LocalSearch::initTry(bool useInitial) {
+        auto &rng = RNG::get();
+        for (std::size_t x = 0; x < numVariables; ++x) {
+            assignment[x] = useInitial && initial[x] != 2 ? initial[x] : static_cast<char>(rng.random_int(0, 1));
+        }
+
+        numTrue.assign(clauses.size(), 0);
+        trueXor.assign(clauses.size(), 0);
+        unsatPos.assign(clauses.size(), 0);
+        std::ranges::fill(breakCount, 0);
+        unsat.clear();
+        for (std::uint32_t c = 0; c < clauses.size(); ++c) {
+            for (Literal l : clauses[c]) {
+                if (isTrue(l)) {
+                    ++numTrue[c];
+                    trueXor[c] ^= var(l).get();
+                }
+            }
+
+            if (numTrue[c] == 0) {
+                makeUnsat(c);
+            } else if (numTrue[c] == 1) {
+                ++breakCount[trueXor[c]];
+            }
+        }
+    }
+
+    void LocalSearch::flip(Variable x) {
+        assignment[x.get()] ^= 1;
+        const Literal becameTrue = assignment[x.get()] ? pos(x) : neg(x);
+        for (std::uint32_t c : occurrences[becameTrue.get()]) {
+            if (numTrue[c] == 0) {
+                makeSat(c);
+                ++breakCount[x.get()];
+            } else if (numTrue[c] == 1) {
+                --breakCount[trueXor[c]];
+            }
+
+            ++numTrue[c];
+            trueXor[c] ^= x.get();
+        }
+
+        for (std::uint32_t c : occurrences[becameTrue.negate().get()]) {
+            --numTrue[c];
+            trueXor[c] ^= x.get();
+            if (numTrue[c] == 0) {
+                makeUnsat(c);
+                --breakCount[x.get()];
+            } else if (numTrue[c] == 1) {
+                ++breakCount[trueXor[c]];
+            }
+        }
+
+        ++flips;
+    }
+
+    Variable LocalSearch::pickProbSat(const Clause &clause) {
+        double sum = 0;
+        weights.clear();
+        for (Literal l : clause) {
+            const std::uint32_t b = breakCount[var(l).get()];
+            weights.emplace_back(b < probabilities.size() ? probabilities[b] : std::pow(Eps + b, -Cb));
+            sum += weights.back();
+        }
+
+        // roulette wheel selection
+        double r = RNG::get().random_float(0.0, sum);
+        auto lit = clause.begin();
+        for (double w : weights) {
+            r -= w;
+            if (r <= 0) {
+                return var(*lit);
+            }
+
+            ++lit;
+        }
+
+        return var(*(clause.end() - 1));
+    }
+
+    Variable LocalSearch::pickWalkSat(const Clause &clause) {
+        auto &rng = RNG::get();
+        std::uint32_t minBreak = std::numeric_limits<std::uint32_t>::max();
+        std::size_t numMin = 0;
+        Literal candidate = *clause.begin();
+        for (Literal l : clause) {
+            const std::uint32_t b = breakCount[var(l).get()];
+            if (b < minBreak) {
+                minBreak = b;
+                numMin = 1;
+                candidate = l;
+            } else if (b == minBreak && rng.random_int<std::size_t>(0, numMin++) == 0) {
+                // reservoir sampling among the variables with minimal break count
+                candidate = l;
+            }
+        }
+
+        if (minBreak > 0 && rng.random_float(0.0, 1.0) < Noise) {
+            const auto i = rng.random_int<std::size_t>(0, clause.size() - 1);
+            return var(*(clause.begin() + static_cast<std::ptrdiff_t>(i)));
+        }
+
+        return var(candidate);
+    }
+
+    bool LocalSearch::solve(std::uint64_t maxFlips, std::optional<std::chrono::steady_clock::time_point> deadline) {
+        if (probabilities.empty()) {
+            std::size_t maxOcc = 0;
+            for (const auto &occ : occurrences) {
+                maxOcc = std::max(maxOcc, occ.size());
+            }
+
+            probabilities.resize(maxOcc + 1);
+            for (std::size_t b = 0; b < probabilities.size(); ++b) {
+                probabilities[b] = std::pow(Eps + static_cast<double>(b), -Cb);
+            }
+        }
+
+        auto &rng = RNG::get();
+        const std::uint64_t tryFlips = std::max<std::uint64_t>(1, TryFactor * numVariables);
+        const std::uint64_t flipLimit = flips + maxFlips;
+        std::uint64_t lastImprovement = flips;
+        bool first = true;
+        bestUnsat = std::numeric_limits<std::size_t>::max();
+        do {
+            initTry(first);
+            first = false;
+            for (std::uint64_t i = 0; true; ++i) {
+                if (unsat.size() < bestUnsat) {
+                    bestUnsat = unsat.size();
+                    best = assignment;
+                    lastImprovement = flips;
+                }
+
+                if (unsat.empty()) {
+                    return true;
+                }
+
+                if (flips - lastImprovement >= maxStagnation) {
+                    return false;
+                }
+
+                if (i == tryFlips || flips >= flipLimit) {
+                    break;
+                }
+
+                if (deadline.has_value() && (flips & 0xfff) == 0 && std::chrono::steady_clock::now() >= *deadline) {
+                    return false;
+                }
+
+                const auto c = unsat[rng.random_int<std::size_t>(0, unsat.size() - 1)];
+                const auto &clause = clauses[c];
+                flip(algorithm == LocalSearchAlgorithm::ProbSat ? pickProbSat(clause) : pickWalkSat(clause));
+            }
+        } while (flips < flipLimit);
+
+        return false;
+    }
+
+    void LocalSearch::setMaxStagnation(std::uint64_t numFlips) {
+        maxStagnation = numFlips;
+    }
+
+    std::vector<Literal> LocalSearch::getModel() const {
+        std::vector<Literal> model;
+        model.reserve(numVariables);
+        for (unsigned x = 0; x < numVariables; ++x) {
+            model.emplace_back(best[x] ? pos(x) : neg(x));
+        }
+
+        return model;
+    }
+
+    bool LocalSearch::verify() const {
+        return std::ranges::all_of(clauses, [this](const Clause &clause) {
+            return std::ranges::any_of(clause, [this](Literal l) { return best[var(l).get()] == (l.sign() > 0); });
+        });
+    }
+
+    std::uint64_t LocalSearch::getFlips() const {
+        return flips;
+    }
+}
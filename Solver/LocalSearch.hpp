@@ -0,0 +1,130 @@
+/**
+* @date 16.10.26
+* @file LocalSearch.hpp
+* @brief Contains a stochastic local search engine (ProbSAT / WalkSAT)
+*/
+
+#ifndef LOCALSEARCH_HPP
+#define LOCALSEARCH_HPP
+
+#include <vector>
+#include <span>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <limits>
+
+#include "basic_structures.hpp"
+#include "Clause.hpp"
+#include "util/enum.hpp"
+
+namespace sat {
+
+    /**
+     * @brief Flip selection strategies of the local search
+     * @details ProbSat: a variable of a random unsatisfied clause is flipped with probability proportional to
+     * (Eps + break)^-Cb. WalkSat (SKC): a variable with break count 0 is flipped if there is one, otherwise a random
+     * variable with probability Noise and a variable with minimal break count else
+     */
+    PENUM(LocalSearchAlgorithm, ProbSat, WalkSat)
+
+    /**
+     * @brief Stochastic local search on complete assignments
+     * @details
+     * Incomplete: can only find models. Keeps for every clause the number of true literals and the XOR of the true
+     * variables (this is the critical variable if exactly one literal is true), the break count of every variable
+     * (number of clauses that become unsatisfied when flipping it) and the list of unsatisfied clauses with O(1)
+     * insertion and removal. A flip only touches the occurrence lists of the flipped variable. All random decisions
+     * are taken with sat::RNG
+     */
+    class LocalSearch {
+    public:
+        static constexpr double Cb = 2.06; ///< ProbSat polynomial break exponent (tuned for 3-SAT)
+        static constexpr double Eps = 0.9; ///< ProbSat break offset
+        static constexpr double Noise = 0.567; ///< WalkSat noise
+        static constexpr std::uint64_t TryFactor = 100; ///< flips per try = TryFactor * number of variables
+
+        /**
+         * Ctor
+         * @param numVariables number of variables
+         * @param algorithm flip selection strategy
+         */
+        explicit LocalSearch(std::size_t numVariables,
+                             LocalSearchAlgorithm algorithm = LocalSearchAlgorithm::ProbSat);
+
+        /**
+         * Adds a clause to the formula. Clauses must be added before calling solve
+         * @param clause non-empty clause
+         */
+        void addClause(std::span<const Literal> clause);
+
+        /**
+         * Searches for a model. Every try starts from a random assignment (the first one from the initial phases if
+         * they were set)
+         * @param maxFlips maximum total number of flips
+         * @param deadline optional wall clock limit
+         * @return true if a model was found (see getModel)
+         */
+        bool solve(std::uint64_t maxFlips,
+                   std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt);
+
+        /**
+         * Stops the search once the fewest number of unsatisfied clauses seen in the current solve call has not
+         * improved for the given number of flips (unlimited by default)
+         * @param numFlips flips without improvement
+         */
+        void setMaxStagnation(std::uint64_t numFlips);
+
+        /**
+         * Sets the starting assignment of the first try
+         * @param assignment literals of the assignment (variables not included start randomly)
+         */
+        void setInitialPhases(std::span<const Literal> assignment);
+
+        /**
+         * Model found by the last call to solve, otherwise the assignment with the fewest unsatisfied clauses
+         * @return one literal per variable
+         */
+        std::vector<Literal> getModel() const;
+
+        /**
+         * Checks the model (see getModel) against all clauses, independent of the incremental data structures
+         * @return true if all clauses are satisfied
+         */
+        bool verify() const;
+
+        /**
+         * Total number of flips done
+         */
+        std::uint64_t getFlips() const;
+
+    private:
+        std::size_t numVariables;
+        LocalSearchAlgorithm algorithm;
+        std::vector<Clause> clauses;
+        std::vector<std::vector<std::uint32_t>> occurrences; ///< clause indices by literal id
+        std::vector<char> assignment; ///< current value by variable id
+        std::vector<char> best; ///< assignment with the fewest unsatisfied clauses seen
+        std::size_t bestUnsat = 0;
+        std::uint64_t maxStagnation = std::numeric_limits<std::uint64_t>::max();
+        std::vector<char> initial; ///< 0 = false, 1 = true, 2 = random
+        std::vector<std::uint32_t> numTrue;
+        std::vector<std::uint32_t> trueXor;
+        std::vector<std::uint32_t> breakCount;
+        std::vector<std::uint32_t> unsat;
+        std::vector<std::uint32_t> unsatPos; ///< position in unsat by clause index
+        std::vector<double> probabilities; ///< ProbSat weights by break count
+        std::vector<double> weights; ///< scratch buffer of pickProbSat
+        std::uint64_t flips = 0;
+
+        bool isTrue(Literal l) const;
+        void initTry(bool useInitial);
+        void makeUnsat(std::uint32_t c);
+        void makeSat(std::uint32_t c);
+        void flip(Variable x);
+        Variable pickProbSat(const Clause &clause);
+        Variable pickWalkSat(const Clause &clause);
+    };
+}
+
+#endif //LOCALSEARCH_HPP
@@ -5,177 +5,502 @@
 */
 
 #include <algorithm>
+#include <array>
 #include <ranges>
 #include <cassert>
+#include <unordered_set>
+#include <limits>
+#include <bit>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 #include "Solver.hpp"
 #include "util/exception.hpp"
+#include "util/assert.hpp"
 #include "heuristics.hpp"
+#include "LocalSearch.hpp"
 
 namespace sat {
     
 
-    static std::size_t luby(std::size_t i) {
-        std::size_t k = 1;
-        while ((1ULL << k) - 1 < i) ++k;
-        while (i != (1ULL << k) - 1) {
-            i = i - ((1ULL << (k - 1)) - 1);
-            k = 1;
-            while ((1ULL << k) - 1 < i) ++k;
-        }
-        return 1ULL << (k - 1);
-    }
-    
-   
+    template<heuristic H, restart_policy R>
+    SolveStatus Solver::dpll(H &h, R &restartPolicy, std::span<const Literal> assumptions) {
+        // set when the lookahead already ran into a conflict
+        bool failed = false;
+        while (true) {
+            if (failed || !unitPropagate()) {
+                failed = false;
+                ++stats.conflicts;
+                if (decisionLevel() == 0) {
+                    rootConflict = true;
+                }
+
+                if (conflictClause != NoClause) {
+                    const auto lits = literals(conflictClause, conflictLiteral);
+                    restartPolicy.onConflict(computeLbd(std::span(lits.begin(), lits.end())), trail.size());
+                }
+
+                updateTargetPhases();
+
+                if (!lastConflictVars.empty()) {
+                    detail::notifyConflict(h, lastConflictVars);
+                }
+
+                // undo up to the most recent decision whose second branch is still open. Assumptions are never flipped
+                while (!decisions.empty() && decisions.back().flipped) {
+                    decisions.pop_back();
+                }
+
+                if (decisions.empty()) {
+                    backtrack(0);
+                    return SolveStatus::Unsat;
+                }
+
+                auto &frame = decisions.back();
+                frame.flipped = true;
+                backtrack(static_cast<unsigned>(decisions.size() - 1));
+                ASSERT_RESULT(decide(frame.decision.negate()));
+                continue;
+            }
+
+            if (decisions.size() < assumptions.size()) {
+                const Literal p = assumptions[decisions.size()];
+                if (!decide(p)) {
+                    backtrack(0);
+                    decisions.clear();
+                    return SolveStatus::Unsat;
+                }
+
+                decisions.push_back({p, true});
+                continue;
+            }
+
+            const std::size_t open = numVariables - trail.size();
+            if (open == 0) {
+                return SolveStatus::Sat;
+            }
+
+            if (limitsReached()) {
+                return SolveStatus::Unknown;
+            }
+
+            if (restartPolicy.shouldRestart()) {
+                return SolveStatus::Restart;
+            }
+
+            Literal l = Literal(0);
+            if (mode == SolveMode::Lookahead) {
+                std::optional<Literal> branch;
+                failed = !lookahead(branch);
+                if (!branch.has_value()) {
+                    continue;
+                }
 
-    SolveStatus Solver::dpll(WeightedDegree &h, std::size_t &decisionBudget) {
-    if (!unitPropagate()) {
-        if (!lastConflictVars.empty()) {
-            h.onConflict(lastConflictVars);
+                l = *branch;
+            } else {
+                l = phases(h(model, open));
+            }
+
+            decisions.push_back({l, false});
+            ASSERT_RESULT(decide(l));
         }
-        return SolveStatus::Unsat;
     }
 
-    std::size_t open = 0;
-    for (auto v : model) {
-        if (v == TruthValue::Undefined) ++open;
+
+    Solver::Solver(unsigned numVariables)
+        : numVariables(numVariables),
+          model(numVariables, TruthValue::Undefined),
+          literalValues(2u * numVariables + GatherPadding, 0),
+          watchLists(2u * numVariables),
+          implications(2u * numVariables),
+          levels(numVariables, 0),
+          reasons(numVariables, NoClause),
+          seen(numVariables, 0),
+          levelStamps(numVariables + 1, 0),
+          brancher(std::in_place_type<VSIDS>, numVariables),
+          phases(numVariables) {
+        trail.reserve(numVariables);
+        decisions.reserve(numVariables);
     }
-    if (open == 0) {
-        return SolveStatus::Sat;
+
+    void Solver::setSolveMode(SolveMode solveMode) {
+        mode = solveMode;
     }
 
-    if (decisionBudget == 0) {
-        return SolveStatus::Restart;
+    void Solver::setPolarity(PhaseMode phaseMode, bool positiveDefault) {
+        phases = PhaseSelector(numVariables, phaseMode, positiveDefault);
+        polarity = phaseMode;
     }
 
-    Variable x = h(model, open);
-    --decisionBudget;
+    void Solver::setSearchRegime(SearchRegime searchRegime) {
+        regime = searchRegime;
+    }
 
-    // branch True
-    {
-        Solver s1 = clone();
-        if (s1.assign(pos(x))) {
-            SolveStatus st = s1.dpll(h, decisionBudget);
-            if (st == SolveStatus::Sat) { *this = std::move(s1); return SolveStatus::Sat; }
-            if (st == SolveStatus::Restart) return SolveStatus::Restart;
+    void Solver::initRegime() {
+        if (regime == SearchRegime::Focused) {
+            // also on a fresh solver: the heuristics start with their stable decay
+            setStable(false);
+            return;
         }
+
+        setStable(regime == SearchRegime::Stable);
+        switchInterval = ModeSwitchInterval;
+        nextSwitch = stats.conflicts + switchInterval;
+        rephases = 0;
+        nextRephase = stats.conflicts + RephaseInterval;
     }
 
-    // branch False
-    {
-        Solver s2 = clone();
-        if (s2.assign(neg(x))) {
-            SolveStatus st = s2.dpll(h, decisionBudget);
-            if (st == SolveStatus::Sat) { *this = std::move(s2); return SolveStatus::Sat; }
-            if (st == SolveStatus::Restart) return SolveStatus::Restart;
+    bool Solver::updateRegime() {
+        if (regime == SearchRegime::Focused) {
+            return false;
         }
+
+        if (stats.conflicts >= nextRephase) {
+            static constexpr std::array Schedule{Rephase::Best, Rephase::Original, Rephase::Best, Rephase::Inverted,
+                                                 Rephase::Best, Rephase::Random};
+            phases.rephase(Schedule[rephases % Schedule.size()]);
+            ++rephases;
+            nextRephase = stats.conflicts + RephaseInterval * (rephases + 1);
+        }
+
+        if (regime == SearchRegime::Alternating && stats.conflicts >= nextSwitch) {
+            setStable(!stable);
+            switchInterval *= 2;
+            nextSwitch = stats.conflicts + switchInterval;
+            return true;
+        }
+
+        return false;
     }
 
-    return SolveStatus::Unsat;
-}
+    void Solver::setStable(bool stableMode) {
+        stable = stableMode;
+        stableRestarts.reset();
+        phases.setMode(stable ? PhaseMode::Target : focusedPolarity());
+        std::visit([this](auto &h) { detail::notifyModeSwitch(h, stable); }, brancher);
+    }
 
+    PhaseMode Solver::focusedPolarity() const {
+        // the phases imported from the local search are only read in saved or target mode
+        if (mode == SolveMode::LocalSearch && polarity != PhaseMode::Saved && polarity != PhaseMode::Target) {
+            return PhaseMode::Saved;
+        }
 
- Solver::Solver(unsigned numVariables)
-        : numVariables(numVariables),
-          model(numVariables, TruthValue::Undefined),
-          watchLists(2u * numVariables) {}
+        return polarity;
+    }
 
-     bool Solver::solve() {
-    Solver base = clone();
-    WeightedDegree h(numVariables, 1.0, 0.95);
+    void Solver::setRestartPolicy(RestartStrategy strategy) {
+        switch (strategy) {
+            case RestartStrategy::Luby:
+                restartPolicy.emplace<LubyRestarts>();
+                return;
+            case RestartStrategy::Geometric:
+                restartPolicy.emplace<GeometricRestarts>();
+                return;
+            case RestartStrategy::Glucose:
+                restartPolicy.emplace<GlucoseRestarts>();
+                return;
+            case RestartStrategy::None:
+                restartPolicy.emplace<NoRestarts>();
+                return;
+        }
 
-    const std::size_t baseBudget = 200;
-    const std::size_t maxRestarts = 50;
+        throw std::runtime_error("unknown restart strategy");
+    }
 
-    for (std::size_t r = 1; r <= maxRestarts; ++r) {
-        Solver attempt = base.clone();
-        std::size_t budget = baseBudget * luby(r);
+    void Solver::setHeuristic(BranchingHeuristic type) {
+        switch (type) {
+            case BranchingHeuristic::Vsids:
+                brancher.emplace<VSIDS>(numVariables);
+                break;
+            case BranchingHeuristic::Lrb:
+                brancher.emplace<LRB>(numVariables);
+                break;
+            case BranchingHeuristic::WeightedDegree:
+                brancher.emplace<WeightedDegree>(numVariables, 1.0, 0.95);
+                break;
+            case BranchingHeuristic::FirstVariable:
+                brancher.emplace<FirstVariable>();
+                break;
+            case BranchingHeuristic::JeroslowWang:
+                brancher.emplace<JeroslowWang>(numVariables);
+                break;
+            case BranchingHeuristic::Moms:
+                brancher.emplace<Moms>(numVariables);
+                break;
+            case BranchingHeuristic::Dlis:
+                brancher.emplace<Dlis>(numVariables);
+                break;
+            default:
+                throw std::runtime_error("unknown branching heuristic");
+        }
 
-        SolveStatus st = attempt.dpll(h, budget);
+        // occurrence based heuristics need to see the clauses added so far
+        for (ClauseRef c : clauses) {
+            notifyClauseAdded(arena.literals(c));
+        }
 
-        if (st == SolveStatus::Sat) {
-            *this = std::move(attempt);
-            return true;
+        for (const auto &b : binaries) {
+            notifyClauseAdded(b);
         }
-        if (st == SolveStatus::Unsat) {
-            return false;
+    }
+
+    void Solver::setHeuristic(Heuristic custom) {
+        if (!custom.isValid()) {
+            throw BadHeuristicCall("heuristic wrapper does not contain a heuristic");
+        }
+
+        brancher.emplace<Heuristic>(std::move(custom));
+        for (ClauseRef c : clauses) {
+            notifyClauseAdded(arena.literals(c));
         }
 
-        // restart
-        h.decay();
+        for (const auto &b : binaries) {
+            notifyClauseAdded(b);
+        }
     }
 
-    return false;
-}
+    Variable Solver::pickBranchVariable(std::size_t numOpen) {
+        return std::visit([&](auto &h) { return Variable(h(model, numOpen)); }, brancher);
+    }
 
+    void Solver::notifyAssign(Variable x) {
+        std::visit([x](auto &h) { detail::notifyAssign(h, x); }, brancher);
+    }
 
+    void Solver::notifyUnassign(Variable x) {
+        std::visit([x](auto &h) { detail::notifyUnassign(h, x); }, brancher);
+    }
 
-    bool Solver::addClause(Clause clause) {
+    void Solver::notifyConflict() {
+        std::visit([this](auto &h) { detail::notifyConflict(h, lastConflictVars); }, brancher);
+    }
 
-    if (clause.isEmpty()) return false;
+    void Solver::notifyRestart() {
+        std::visit([](auto &h) { detail::notifyRestart(h); }, brancher);
+    }
 
-    std::vector<Literal> newLits;
-    newLits.reserve(clause.size());
+    void Solver::notifyClauseAdded(std::span<const Literal> clause) {
+        std::visit([clause](auto &h) { detail::notifyClauseAdded(h, clause); }, brancher);
+    }
 
-    for (auto l : clause) {
-        if (satisfied(l)) {
-            return true;
+    void Solver::notifyClauseRemoved(std::span<const Literal> clause) {
+        std::visit([clause](auto &h) { detail::notifyClauseRemoved(h, clause); }, brancher);
+    }
+
+    void Solver::updateTargetPhases() {
+        if (trailLimits.empty()) return;
+
+        phases.updateTarget(std::span(trail).first(trailLimits.back()));
+    }
+
+    bool Solver::solve(std::span<const Literal> assumptions) {
+        return search(assumptions, false) == SolveStatus::Sat;
+    }
+
+    void Solver::setLimits(const SolveLimits &solveLimits) {
+        limits = solveLimits;
+    }
+
+    SolveStatus Solver::solveLimited(std::span<const Literal> assumptions) {
+        return search(assumptions, true);
+    }
+
+    const SolveStatistics &Solver::getStatistics() const {
+        return stats;
+    }
+
+    SolveStatus Solver::search(std::span<const Literal> assumptions, bool useLimits) {
+        limited = useLimits;
+        callStart = stats;
+        deadline.reset();
+        if (useLimits && limits.time != std::chrono::milliseconds::max()) {
+            deadline = std::chrono::steady_clock::now() + limits.time;
         }
-        if (!falsified(l)) {
-            newLits.emplace_back(l);
+
+        const bool resume = suspended.active && suspended.mode == mode &&
+                            std::ranges::equal(suspended.assumptions, assumptions);
+        if (!resume) {
+            resetSearch();
+        }
+
+        suspended.active = false;
+        SolveStatus status = SolveStatus::Unknown;
+        switch (mode) {
+            case SolveMode::Dpll:
+                status = runDpll(assumptions, resume);
+                break;
+            case SolveMode::FirstVariable:
+                status = runFirstVariable(assumptions, resume);
+                break;
+            case SolveMode::Cdcl:
+                status = runCdcl(assumptions, resume);
+                break;
+            case SolveMode::Lookahead:
+                status = runLookahead(assumptions, resume);
+                break;
+            case SolveMode::LocalSearch:
+                status = runLocalSearch(assumptions, resume);
+                break;
         }
+
+        if (status == SolveStatus::Unknown) {
+            suspended.active = true;
+            suspended.mode = mode;
+            suspended.assumptions.assign(assumptions.begin(), assumptions.end());
+        }
+
+        limited = false;
+        return status;
     }
 
-    if (newLits.empty()) {
-        return false;
+    bool Solver::limitsReached() const {
+        if (!limited) return false;
+
+        return stats.conflicts - callStart.conflicts >= limits.conflicts ||
+               stats.decisions - callStart.decisions >= limits.decisions ||
+               stats.propagations - callStart.propagations >= limits.propagations ||
+               (deadline.has_value() && std::chrono::steady_clock::now() >= *deadline);
     }
 
-    if (newLits.size() == 1) {
-        // unit clause
-        Literal u = newLits[0];
+    void Solver::resetSearch() {
+        backtrack(0);
+        decisions.clear();
+        suspended.active = false;
+    }
 
-        auto it = std::find(unitLiterals.begin(), unitLiterals.end(), u);
-        if (it == unitLiterals.end()) unitLiterals.emplace_back(u);
+    SolveStatus Solver::runDpll(std::span<const Literal> assumptions, bool resume) {
+        if (!resume) {
+            std::visit([](auto &r) { r.reset(); }, restartPolicy);
+        }
 
-        if (falsified(u)) return false;
+        while (true) {
+            SolveStatus st = std::visit([&](auto &h, auto &r) { return dpll(h, r, assumptions); }, brancher,
+                                        restartPolicy);
+            if (st != SolveStatus::Restart) {
+                return st;
+            }
 
-        return true;
+            // the kept decision prefix keeps its frames (including the flags of already flipped decisions)
+            restart(assumptions.size());
+            decisions.erase(decisions.begin() + decisionLevel(), decisions.end());
+            std::visit([](auto &r) { r.onRestart(); }, restartPolicy);
+        }
     }
 
-    ClausePointer cptr = std::make_shared<Clause>(Clause(std::move(newLits)));
+    unsigned Solver::reuseTrailLevel(std::size_t keepLevels) const {
+        const auto minLevel = static_cast<unsigned>(std::min<std::size_t>(keepLevels, decisionLevel()));
+        return std::visit([&](const auto &h) {
+            if constexpr (requires { h.score(Variable(0)); }) {
+                // score of the variable the heuristic would decide next after a full restart
+                double next = -std::numeric_limits<double>::infinity();
+                for (unsigned x = 0; x < numVariables; ++x) {
+                    if (model[x] == TruthValue::Undefined) {
+                        next = std::max(next, static_cast<double>(h.score(x)));
+                    }
+                }
 
-    clauses.emplace_back(cptr);
+                unsigned level = minLevel;
+                while (level < decisionLevel() && trailLimits[level] < trail.size() &&
+                       h.score(var(trail[trailLimits[level]])) > next) {
+                    ++level;
+                }
+
+                return level;
+            } else {
+                return minLevel;
+            }
+        }, brancher);
+    }
 
-    // register watchers in watch lists
-    Literal w0 = cptr->getWatcherByRank(0);
-    Literal w1 = cptr->getWatcherByRank(1);
+    void Solver::restart(std::size_t keepLevels) {
+        const unsigned level = reuseTrailLevel(keepLevels);
+        backtrack(level);
+        // the assumption levels are always kept, only decisions beyond them are saved work
+        if (level > keepLevels) {
+            ++stats.partialRestarts;
+            stats.reusedAssignments += trail.size() - trailLimits[keepLevels];
+        }
 
-    watchLists[w0.get()].push_back(cptr);
-    if (!(w1 == w0)) {
-        watchLists[w1.get()].push_back(cptr);
+        ++stats.restarts;
+        notifyRestart();
+        removeSatisfied();
     }
-    return true;
-}
 
+    bool Solver::addClause(Clause clause) {
+        resetSearch();
+        if (clause.isEmpty()) {
+            rootConflict = true;
+            return false;
+        }
+
+        auto &newLits = clauseBuffer;
+        newLits.clear();
+        for (auto l : clause) {
+            if (satisfied(l)) {
+                return true;
+            }
+
+            // duplicate literals would break the watcher positions, tautologies are always satisfied
+            if (std::ranges::find(newLits, l.negate()) != newLits.end()) {
+                return true;
+            }
+
+            if (!falsified(l) && std::ranges::find(newLits, l) == newLits.end()) {
+                newLits.emplace_back(l);
+            }
+        }
+
+        if (newLits.empty()) {
+            rootConflict = true;
+            return false;
+        }
+
+        if (newLits.size() == 1) {
+            // unit clause: goes directly onto the trail and is propagated by the next unitPropagate
+            if (!assign(newLits[0])) {
+                rootConflict = true;
+                return false;
+            }
+
+            return true;
+        }
+
+        if (newLits.size() == 2) {
+            binaries.push_back({newLits[0], newLits[1]});
+            notifyClauseAdded(newLits);
+            implications[newLits[0].negate().get()].emplace_back(newLits[1]);
+            implications[newLits[1].negate().get()].emplace_back(newLits[0]);
+            return true;
+        }
+
+        const ClauseRef cref = arena.allocate(newLits);
+
+        clauses.emplace_back(cref);
+        notifyClauseAdded(arena.literals(cref));
+
+        // register watchers (the first two literals) in watch lists
+        watchLists[newLits[0].get()].push_back({cref, newLits[1]});
+        watchLists[newLits[1].get()].push_back({cref, newLits[0]});
+        return true;
+    }
 
     /**
-     * Here you have a possible implementation of the rebase-method. It should work out of the box.
-     * To use it, remove the throw-expression and un-comment the code below. The implementation requires that
-     * your solver has some sort of container of pointer types to clause called 'clauses'
-     * (e.g. std::vector<ClausePointer>). Additionally, your solver needs to have a container of unit literals
-     * called 'unitLiterals'.
+     * Reduces the problem clauses under the current assignment: the long clauses ('clauses', references into the
+     * clause arena) and the binary clauses ('binaries') without satisfied clauses and falsified literals, followed by
+     * the literals of the trail as unit clauses (the root level units unless a model is assigned). Learned clauses are
+     * not included
      */
     auto Solver::rebase() const -> std::vector<Clause> {
         std::vector<Clause> reducedClauses;
         // We check all clauses in the solver. If the clause is SAT (at least one literal is satisfied), we don't include it.
         // Additionally, we remove all falsified literals from the clauses since we only care about unassigned literals.
-        for (const auto &c: clauses) {
-            bool sat = false;
-            std::vector<Literal> newLits;
-            newLits.reserve(c->size());
-            for (auto l: *c) {
+        std::vector<Literal> newLits;
+        auto addReduced = [&](std::span<const Literal> lits) {
+            newLits.clear();
+            for (auto l: lits) {
                 if (satisfied(l)) {
-                    sat = true;
-                    break;
+                    return;
                 }
 
                 if (!falsified(l)) {
@@ -183,22 +508,29 @@ namespace sat {
                 }
             }
 
-            if (!sat) {
-                Clause newClause(std::move(newLits));
-                auto res = std::ranges::find_if(reducedClauses, [&newClause](const auto &clause) {
-                    return clause.sameLiterals(newClause);
-                });
+            // short clauses are copied into the clause object without allocation
+            Clause newClause{std::span<const Literal>(newLits)};
+            auto res = std::ranges::find_if(reducedClauses, [&newClause](const auto &clause) {
+                return clause.sameLiterals(newClause);
+            });
 
-                if (res == reducedClauses.end()) {
-                    reducedClauses.emplace_back(std::move(newClause));
-                }
-               // else: duplicate clause after reduction => do not add
+            if (res == reducedClauses.end()) {
+                reducedClauses.emplace_back(std::move(newClause));
             }
+            // else: duplicate clause after reduction => do not add
+        };
+
+        for (ClauseRef c: clauses) {
+            addReduced(arena.literals(c));
+        }
+
+        // learned binaries are only stored in the implication lists and are not part of the problem
+        for (const auto &b : binaries) {
+            addReduced(b);
         }
 
-       
-        for (Literal l: unitLiterals) {
-            reducedClauses.emplace_back(std::vector{l});
+        for (const Literal &l: trail) {
+            reducedClauses.emplace_back(std::span(&l, 1));
         }
 
         return reducedClauses;
@@ -211,194 +543,684 @@ namespace sat {
     }
 
     bool Solver::satisfied(Literal l) const {
-        Variable x = var(l);
-        TruthValue v = val(x);
-        if (v == TruthValue::Undefined) return false;
-
-        
-        if (l.sign() > 0) return v == TruthValue::True;
-        return v == TruthValue::False;
+        assert(l.get() < literalValues.size());
+        return literalValues[l.get()] > 0;
     }
 
     bool Solver::falsified(Literal l) const {
-        return satisfied(l.negate());
+        assert(l.get() < literalValues.size());
+        return literalValues[l.get()] < 0;
     }
 
     bool Solver::assign(Literal l) {
-    Variable x = var(l);
-    assert(x.get() < numVariables);
+        return assign(l, NoClause);
+    }
 
-    if (falsified(l)) return false;
+    bool Solver::assign(Literal l, ClauseRef reason) {
+        Variable x = var(l);
+        assert(x.get() < numVariables);
 
-    if (satisfied(l)) return true;
+        if (falsified(l)) return false;
 
-    model[x.get()] = (l.sign() > 0) ? TruthValue::True : TruthValue::False;
+        if (satisfied(l)) return true;
 
-    // store assignment as unit literal (tests expect this)
-    auto it = std::find(unitLiterals.begin(), unitLiterals.end(), l);
-    if (it == unitLiterals.end()) unitLiterals.emplace_back(l);
+        model[x.get()] = (l.sign() > 0) ? TruthValue::True : TruthValue::False;
+        literalValues[l.get()] = 1;
+        literalValues[l.negate().get()] = -1;
+        levels[x.get()] = decisionLevel();
+        reasons[x.get()] = reason;
+        trail.emplace_back(l);
+        notifyAssign(x);
+        return true;
+    }
 
-    return true;
-}
+    bool Solver::isBinary(ClauseRef reason) {
+        return reason != NoClause && (reason & BinaryTag);
+    }
 
-    bool Solver::unitPropagate() {
-    std::vector<Literal> queue = unitLiterals;
-    std::size_t qHead = 0;
-    lastConflictVars.clear();
+    auto Solver::literals(ClauseRef reason, Literal implied) const -> ClauseLiterals {
+        if (isBinary(reason)) {
+            return {implied, Literal(reason & ~BinaryTag)};
+        }
 
+        return ClauseLiterals(arena.literals(reason));
+    }
 
-    while (qHead < queue.size()) {
-        Literal l = queue[qHead++];
+    bool Solver::decide(Literal l) {
+        if (falsified(l)) return false;
 
-        if (!assign(l)) return false;
+        ++stats.decisions;
+        trailLimits.emplace_back(trail.size());
+        ASSERT_RESULT(assign(l));
+        return true;
+    }
 
-        Literal falselit = l.negate();
-        auto &watchVec = watchLists[falselit.get()];
+    unsigned Solver::decisionLevel() const {
+        return static_cast<unsigned>(trailLimits.size());
+    }
 
-        std::size_t i = 0;
-        while (i < watchVec.size()) {
-            ClausePointer c = watchVec[i];
+    void Solver::backtrack(unsigned level) {
+        if (decisionLevel() <= level) return;
 
-            short rank = c->getRank(falselit);
-            if (rank == -1) {
-                ++i;
-                continue;
+        const std::size_t limit = trailLimits[level];
+        for (std::size_t i = trail.size(); i > limit; --i) {
+            model[var(trail[i - 1]).get()] = TruthValue::Undefined;
+            literalValues[trail[i - 1].get()] = 0;
+            literalValues[trail[i - 1].negate().get()] = 0;
+            phases.onUnassign(trail[i - 1]);
+            notifyUnassign(var(trail[i - 1]));
+        }
+
+        trail.erase(trail.begin() + static_cast<std::ptrdiff_t>(limit), trail.end());
+        trailLimits.resize(level);
+        qHead = std::min(qHead, limit);
+    }
+
+    template<std::size_t N>
+    std::size_t Solver::findReplacement(std::span<const Literal, N> lits) const {
+        if constexpr (N == 3) {
+            // the only literal that is not watched
+            return falsified(lits[2]) ? 3 : 2;
+        } else {
+            // fixed trip count for small clauses: the loop is unrolled
+            for (std::size_t j = 2; j < lits.size(); ++j) {
+                if (!falsified(lits[j])) {
+                    return j;
+                }
             }
 
-            short otherRank = (rank == 0) ? 1 : 0;
-            Literal other = c->getWatcherByRank(otherRank);
+            return lits.size();
+        }
+    }
+
+    std::size_t Solver::findReplacement(std::span<const Literal> lits) const {
+        static_assert(MaxKernelSize == 8);
+        switch (lits.size()) {
+            case 3:
+                return findReplacement(lits.first<3>());
+            case 4:
+                return findReplacement(lits.first<4>());
+            case 5:
+                return findReplacement(lits.first<5>());
+            case 6:
+                return findReplacement(lits.first<6>());
+            case 7:
+                return findReplacement(lits.first<7>());
+            case 8:
+                return findReplacement(lits.first<8>());
+            default:
+                return findLongReplacement(lits);
+        }
+    }
 
-            // If the other watcher is satisfied, clause is satisfied
-            if (satisfied(other)) {
-                ++i;
-                continue;
+    std::size_t Solver::findLongReplacement(std::span<const Literal> lits) const {
+        std::size_t j = 2;
+#ifdef __AVX2__
+        static_assert(sizeof(Literal) == sizeof(std::int32_t));
+        const auto *values = reinterpret_cast<const int *>(literalValues.data());
+        for (; j + LongKernelWidth <= lits.size(); j += LongKernelWidth) {
+            const __m256i ids = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lits.data() + j));
+            // gathers 4 bytes at each literal id, the lowest one is the value of the literal
+            const __m256i vals = _mm256_i32gather_epi32(values, ids, 1);
+            // the sign of the value byte becomes the sign of the lane: bit i is set iff lits[j + i] is falsified
+            const auto falseMask = static_cast<unsigned>(
+                _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_slli_epi32(vals, 24))));
+            if (falseMask != 0xffu) {
+                return j + static_cast<std::size_t>(std::countr_one(falseMask));
+            }
+        }
+#endif
+        for (; j < lits.size(); ++j) {
+            if (!falsified(lits[j])) {
+                return j;
+            }
+        }
+
+        return lits.size();
+    }
+
+    bool Solver::unitPropagate() {
+        lastConflictVars.clear();
+        if (rootConflict) return false;
+
+        // only the literals assigned since the last call are visited
+        while (qHead < trail.size()) {
+            Literal falselit = trail[qHead++].negate();
+            ++stats.propagations;
+
+            // binary clauses propagate directly to the other literal
+            for (Literal implied : implications[falselit.negate().get()]) {
+                if (satisfied(implied)) continue;
+
+                if (falsified(implied)) {
+                    conflictClause = BinaryTag | implied.get();
+                    conflictLiteral = falselit;
+                    lastConflictVars.assign({var(falselit), var(implied)});
+                    return false;
+                }
+
+                ASSERT_RESULT(assign(implied, BinaryTag | falselit.get()));
             }
 
-            // Try to find a replacement watcher that is not falsified
-            bool moved = false;
-            for (auto cand : *c) {
-                if (cand == other) continue;
-                if (cand == falselit) continue;
+            auto &watchVec = watchLists[falselit.get()];
+
+            std::size_t i = 0;
+            while (i < watchVec.size()) {
+                // satisfied clauses are skipped without touching the clause
+                if (satisfied(watchVec[i].blocker)) {
+                    ++i;
+                    continue;
+                }
+
+                const ClauseRef c = watchVec[i].clause;
+                const auto lits = arena.literals(c);
+                // the falsified watcher is moved to position 1
+                if (lits[0] == falselit) {
+                    std::swap(lits[0], lits[1]);
+                }
+
+                assert(lits[1] == falselit);
+                const Literal other = lits[0];
+
+                // If the other watcher is satisfied, clause is satisfied
+                if (satisfied(other)) {
+                    watchVec[i].blocker = other;
+                    ++i;
+                    continue;
+                }
 
-                if (!falsified(cand)) {
-                    bool ok = c->setWatcher(cand, rank);
-                    (void)ok;
+                // Try to find a replacement watcher that is not falsified and swap it into place
+                const std::size_t j = findReplacement(lits);
+                if (j < lits.size()) {
+                    std::swap(lits[1], lits[j]);
                     watchVec[i] = watchVec.back();
                     watchVec.pop_back();
-                    watchLists[cand.get()].push_back(c);
-                    moved = true;
-                    break;
+                    watchLists[lits[1].get()].push_back({c, other});
+                    continue;
+                }
+
+                if (falsified(other)) {
+                    // conflict: store vars from conflicting clause for heuristic update
+                    conflictClause = c;
+                    lastConflictVars.reserve(lits.size());
+                    for (auto lit : lits) {
+                        lastConflictVars.emplace_back(var(lit));
+                    }
+                    return false;
                 }
+
+                ASSERT_RESULT(assign(other, c));
+                ++i;
             }
+        }
+
+        return true;
+    }
+
+    std::vector<Literal> Solver::getUnitLiterals() const {
+        return trail;
+    }
 
-            if (moved) {
+    bool Solver::solveFirstVariable() {
+        resetSearch();
+        return runFirstVariable({}, false) == SolveStatus::Sat;
+    }
+
+    SolveStatus Solver::runFirstVariable(std::span<const Literal> assumptions, bool) {
+        FirstVariable h;
+        NoRestarts r;
+        return dpll(h, r, assumptions);
+    }
+
+    SolveStatus Solver::runLookahead(std::span<const Literal> assumptions, bool) {
+        // branching is done by lookahead(), the heuristic is not consulted
+        FirstVariable h;
+        NoRestarts r;
+        return dpll(h, r, assumptions);
+    }
+
+    SolveStatus Solver::runLocalSearch(std::span<const Literal> assumptions, bool resume) {
+        if (!resume && !rootConflict) {
+            LocalSearch localSearch(numVariables);
+            for (ClauseRef c : clauses) {
+                localSearch.addClause(arena.literals(c));
+            }
+
+            for (const auto &b : binaries) {
+                localSearch.addClause(b);
+            }
+
+            const std::size_t rootSize = trailLimits.empty() ? trail.size() : trailLimits.front();
+            for (std::size_t i = 0; i < rootSize; ++i) {
+                localSearch.addClause(Clause({trail[i]}));
+            }
+
+            for (Literal a : assumptions) {
+                localSearch.addClause(Clause({a}));
+            }
+
+            // CDCL takes over once the local search stagnates. The window is longer than a try, otherwise the local
+            // search would always stop before its first restart
+            static_assert(LocalSearchStagnation > LocalSearch::TryFactor);
+            localSearch.setMaxStagnation(LocalSearchStagnation * numVariables);
+            localSearch.solve(LocalSearchMaxFlips, limited ? deadline : std::nullopt);
+            stats.flips += localSearch.getFlips();
+            if (localSearch.verify()) {
+                // the model satisfies all clauses, the root units and the assumptions => no CDCL search needed
+                trailLimits.emplace_back(trail.size());
+                for (Literal l : localSearch.getModel()) {
+                    ASSERT_RESULT(assign(l));
+                }
+
+                return SolveStatus::Sat;
+            }
+
+            phases.importPhases(localSearch.getModel());
+        }
+
+        return runCdcl(assumptions, resume);
+    }
+
+    std::optional<std::size_t> Solver::probe(Literal l, std::vector<Literal> &implied) {
+        trailLimits.emplace_back(trail.size());
+        const std::size_t start = trail.size();
+        ASSERT_RESULT(assign(l, NoClause));
+        const bool ok = unitPropagate();
+        implied.assign(trail.begin() + static_cast<std::ptrdiff_t>(start), trail.end());
+        backtrack(decisionLevel() - 1);
+        if (!ok) {
+            implied.clear();
+            return {};
+        }
+
+        return implied.size();
+    }
+
+    bool Solver::lookahead(std::optional<Literal> &branch) {
+        branch.reset();
+        bool fixed = false;
+        double bestScore = -1;
+        Literal best = Literal(0);
+        std::vector<Literal> posImplied, negImplied, necessary;
+        // literal marks in seen: 1 = positive, 2 = negative literal implied by the positive phase
+        auto mark = [](Literal l) { return static_cast<char>(l.sign() > 0 ? 1 : 2); };
+        for (unsigned x = 0; x < numVariables; ++x) {
+            if (model[x] != TruthValue::Undefined) {
                 continue;
             }
 
-            if (falsified(other)) {
-                // conflict: store vars from conflicting clause for heuristic update
-                lastConflictVars.clear();
-                lastConflictVars.reserve(c->size());
-                for (auto lit : *c) {
-                    lastConflictVars.emplace_back(var(lit));
+            const auto posReduction = probe(pos(x), posImplied);
+            const auto negReduction = probe(neg(x), negImplied);
+            if (!posReduction.has_value() || !negReduction.has_value()) {
+                // failed literal: the opposite phase is implied by the current assignment. If both phases fail,
+                // propagating either one reproduces the conflict
+                fixed = true;
+                ASSERT_RESULT(assign(posReduction.has_value() ? pos(x) : neg(x), NoClause));
+                if (!unitPropagate()) {
+                    return false;
                 }
-                return false;
+
+                continue;
             }
 
+            // literals implied by both phases are necessary assignments
+            necessary.clear();
+            for (Literal u : posImplied) {
+                seen[var(u).get()] = mark(u);
+            }
 
-            if (!assign(other)) return false;
+            for (Literal u : negImplied) {
+                if (seen[var(u).get()] == mark(u)) {
+                    necessary.emplace_back(u);
+                }
+            }
 
-            queue.push_back(other);
+            for (Literal u : posImplied) {
+                seen[var(u).get()] = 0;
+            }
+
+            if (!necessary.empty()) {
+                fixed = true;
+                for (Literal u : necessary) {
+                    if (!satisfied(u)) {
+                        ASSERT_RESULT(assign(u, NoClause));
+                    }
+                }
 
-            ++i;
+                if (!unitPropagate()) {
+                    return false;
+                }
+
+                continue;
+            }
+
+            const double p = static_cast<double>(*posReduction);
+            const double n = static_cast<double>(*negReduction);
+            const double score = 1024 * p * n + p + n;
+            if (score > bestScore) {
+                bestScore = score;
+                best = p >= n ? pos(x) : neg(x);
+            }
         }
+
+        // failed literals changed the formula: the caller reruns the lookahead on the new node
+        if (!fixed && bestScore >= 0) {
+            branch = best;
+        }
+
+        return true;
     }
 
-    return true;
-}
+    unsigned Solver::analyze(std::vector<Literal> &learnt) {
+        learnt.clear();
+        learnt.emplace_back(0u); // placeholder for the asserting literal
+        lastConflictVars.clear();
+
+        const unsigned conflictLevel = decisionLevel();
+        unsigned pathCount = 0;
+        ClauseRef reason = conflictClause;
+        std::size_t index = trail.size();
+        bool resolving = false;
+        Literal p = conflictLiteral;
+
+        // resolve backwards along the trail until only one literal of the conflict level is left (1UIP)
+        do {
+            assert(reason != NoClause);
+            for (Literal q : literals(reason, p)) {
+                if (resolving && q == p) continue;
+
+                Variable x = var(q);
+                if (!seen[x.get()] && levels[x.get()] > 0) {
+                    seen[x.get()] = 1;
+                    lastConflictVars.emplace_back(x);
+                    if (levels[x.get()] >= conflictLevel) {
+                        ++pathCount;
+                    } else {
+                        learnt.emplace_back(q);
+                    }
+                }
+            }
 
- /*
-     * IMPORTANT:
-     * Clause objects contain mutable watcher indices. Therefore, we must deep-copy clauses for branching,
-     * otherwise different branches share the same Clause instances and interfere.
-     */
-    Solver Solver::clone() const {
-        Solver s(numVariables);
-        s.model = model;
-        s.unitLiterals = unitLiterals;
+            while (!seen[var(trail[--index]).get()]);
+            p = trail[index];
+            reason = reasons[var(p).get()];
+            seen[var(p).get()] = 0;
+            resolving = true;
+            --pathCount;
+        } while (pathCount > 0);
+
+        learnt[0] = p.negate();
+        minimize(learnt);
+        for (Variable x : lastConflictVars) {
+            seen[x.get()] = 0;
+        }
 
-        // recreate clauses with new Clause instances
-        s.clauses.reserve(clauses.size());
-        for (const auto &cp : clauses) {
-            ClausePointer np = std::make_shared<Clause>(*cp); // deep copy Clause (literals + watcher indices)
-            s.clauses.emplace_back(np);
+        // the literal with the highest level after the UIP determines the backjump level and becomes 2nd watcher
+        unsigned btLevel = 0;
+        for (std::size_t i = 1; i < learnt.size(); ++i) {
+            const unsigned l = levels[var(learnt[i]).get()];
+            if (l > btLevel) {
+                btLevel = l;
+                std::swap(learnt[1], learnt[i]);
+            }
         }
 
-        // rebuild watchLists
-        s.watchLists.assign(2u * numVariables, {});
-        for (const auto &cp : s.clauses) {
-            if (cp->isEmpty()) continue;
-            Literal w0 = cp->getWatcherByRank(0);
-            Literal w1 = cp->getWatcherByRank(1);
-            s.watchLists[w0.get()].push_back(cp);
-            if (!(w1 == w0)) {
-                s.watchLists[w1.get()].push_back(cp);
+        return btLevel;
+    }
+
+    void Solver::minimize(std::vector<Literal> &learnt) const {
+        // a literal is redundant if all other literals of its reason are already in the clause (or root level)
+        auto redundant = [this](Literal l) {
+            const ClauseRef reason = reasons[var(l).get()];
+            if (reason == NoClause) return false;
+            return std::ranges::all_of(literals(reason, l.negate()), [&](Literal q) {
+                Variable x = var(q);
+                return x == var(l) || seen[x.get()] || levels[x.get()] == 0;
+            });
+        };
+
+        auto res = std::remove_if(learnt.begin() + 1, learnt.end(), redundant);
+        learnt.erase(res, learnt.end());
+    }
+
+    unsigned Solver::computeLbd(std::span<const Literal> clause) {
+        unsigned lbd = 0;
+        ++lbdStamp;
+        for (Literal l : clause) {
+            const unsigned lvl = levels[var(l).get()];
+            // duplicate or satisfied assumptions open empty levels => there can be more levels than variables
+            if (lvl >= levelStamps.size()) {
+                levelStamps.resize(lvl + 1, 0);
+            }
+
+            if (levelStamps[lvl] != lbdStamp) {
+                levelStamps[lvl] = lbdStamp;
+                ++lbd;
             }
         }
 
-        return s;
+        return lbd;
     }
-    std::vector<Literal> Solver::getUnitLiterals() const {
-    return unitLiterals;
+
+    unsigned Solver::learn(std::vector<Literal> learnt) {
+        if (learnt.size() == 1) {
+            assert(decisionLevel() == 0);
+            ASSERT_RESULT(assign(learnt.front()));
+            return 1;
+        }
+
+        const unsigned lbd = computeLbd(learnt);
+        const Literal asserting = learnt.front();
+        if (learnt.size() == 2) {
+            implications[learnt[0].negate().get()].emplace_back(learnt[1]);
+            implications[learnt[1].negate().get()].emplace_back(learnt[0]);
+            ASSERT_RESULT(assign(asserting, BinaryTag | learnt[1].get()));
+            return lbd;
+        }
+
+        // Clause watches its first two literals: the asserting literal and the one of the backjump level
+        const ClauseRef c = arena.allocate(learnt, true);
+        watchLists[learnt[0].get()].push_back({c, learnt[1]});
+        watchLists[learnt[1].get()].push_back({c, learnt[0]});
+        learnts.emplace_back(c, lbd);
+        ASSERT_RESULT(assign(asserting, c));
+        return lbd;
     }
-        
-    bool Solver::solveFirstVariable() {
-    return dpllFirstVariable();
-}
 
-bool Solver::dpllFirstVariable() {
-    // 1) Unit propagation
-    if (!unitPropagate()) return false;
+    void Solver::reduceLearnts() {
+        assert(decisionLevel() == 0);
+        std::ranges::stable_sort(learnts, {}, [this](const auto &lc) {
+            return std::pair(lc.lbd, arena.size(lc.clause));
+        });
+
+        // glue clauses (lbd <= 2) are always kept
+        bool removed = false;
+        const std::size_t keep = learnts.size() / 2;
+        for (std::size_t i = keep; i < learnts.size(); ++i) {
+            if (learnts[i].lbd > 2) {
+                arena.free(learnts[i].clause);
+                removed = true;
+            }
+        }
+
+        if (!removed) return;
 
-    // 2) Check if all assigned
-    std::size_t open = 0;
-    for (auto v : model) {
-        if (v == TruthValue::Undefined) ++open;
+        std::erase_if(learnts, [this](const auto &lc) { return arena.isDeleted(lc.clause); });
+        for (auto &watchVec : watchLists) {
+            std::erase_if(watchVec, [this](const Watcher &w) { return arena.isDeleted(w.clause); });
+        }
+
+        collectGarbage();
     }
-    if (open == 0) return true;
 
-    // 3) Choose next variable (FirstVariable)
-    FirstVariable hv;
-    Variable x = hv(model, open);
+    void Solver::removeSatisfied() {
+        const std::size_t rootSize = trailLimits.empty() ? trail.size() : trailLimits.front();
+        if (rootSize == simplifiedTrailSize) return;
+
+        simplifiedTrailSize = rootSize;
+        auto isSatisfied = [this](ClauseRef c) {
+            return std::ranges::any_of(arena.literals(c), [this](Literal l) {
+                return satisfied(l) && levels[var(l).get()] == 0;
+            });
+        };
+
+        auto rootSatisfied = [this](Literal l) { return satisfied(l) && levels[var(l).get()] == 0; };
+        std::erase_if(binaries, [&](const auto &b) {
+            if (!std::ranges::any_of(b, rootSatisfied)) return false;
+            notifyClauseRemoved(b);
+            return true;
+        });
+
+        for (std::size_t l = 0; l < implications.size(); ++l) {
+            if (rootSatisfied(Literal(static_cast<unsigned>(l)).negate())) {
+                implications[l].clear();
+            } else {
+                std::erase_if(implications[l], rootSatisfied);
+            }
+        }
+
+        bool removed = false;
+        std::erase_if(clauses, [&](ClauseRef c) {
+            if (!isSatisfied(c)) return false;
+            notifyClauseRemoved(arena.literals(c));
+            arena.free(c);
+            removed = true;
+            return true;
+        });
 
-    // 4) Branch True
-    {
-        Solver s1 = clone();
-        if (s1.assign(pos(x)) && s1.dpllFirstVariable()) {
-            *this = std::move(s1);
+        std::erase_if(learnts, [&](const LearntClause &lc) {
+            if (!isSatisfied(lc.clause)) return false;
+            arena.free(lc.clause);
+            removed = true;
             return true;
+        });
+
+        if (!removed) return;
+
+        for (auto &watchVec : watchLists) {
+            std::erase_if(watchVec, [this](const Watcher &w) { return arena.isDeleted(w.clause); });
         }
+
+        collectGarbage();
     }
 
-    // 5) Branch False
-    {
-        Solver s2 = clone();
-        if (s2.assign(neg(x)) && s2.dpllFirstVariable()) {
-            *this = std::move(s2);
-            return true;
+    void Solver::collectGarbage() {
+        if (static_cast<double>(arena.garbage()) <= GarbageFraction * static_cast<double>(arena.capacity())) return;
+
+        ClauseArena compacted;
+        compacted.reserve(arena.capacity() - arena.garbage());
+        // problem clauses first, then learned clauses: the relative order of the clauses is kept
+        for (ClauseRef &c : clauses) {
+            c = arena.relocate(c, compacted);
+        }
+
+        for (auto &lc : learnts) {
+            lc.clause = arena.relocate(lc.clause, compacted);
         }
+
+        // watch lists do not contain deleted clauses. Reasons of root level literals might have been deleted
+        for (auto &watchVec : watchLists) {
+            for (Watcher &w : watchVec) {
+                w.clause = arena.relocate(w.clause, compacted);
+            }
+        }
+
+        for (Literal l : trail) {
+            ClauseRef &reason = reasons[var(l).get()];
+            if (reason != NoClause && !isBinary(reason)) {
+                reason = arena.relocate(reason, compacted);
+            }
+        }
+
+        conflictClause = NoClause;
+        arena = std::move(compacted);
     }
 
-    return false;
-}
+    bool Solver::solveCdcl() {
+        resetSearch();
+        return runCdcl({}, false) == SolveStatus::Sat;
+    }
 
+    SolveStatus Solver::runCdcl(std::span<const Literal> assumptions, bool resume) {
+        return std::visit([&](auto &r) { return cdcl(r, assumptions, resume); }, restartPolicy);
+    }
 
+    template<restart_policy R>
+    SolveStatus Solver::cdcl(R &restartPolicy, std::span<const Literal> assumptions, bool resume) {
+        std::vector<Literal> learnt;
+        if (!resume) {
+            restartPolicy.reset();
+            initRegime();
+        }
 
-        
+        maxLearnts = std::max({maxLearnts, clauses.size() / 3, std::size_t(2000)});
 
+        while (true) {
+            if (!unitPropagate()) {
+                ++stats.conflicts;
+                if (decisionLevel() == 0) {
+                    rootConflict = true;
+                    return SolveStatus::Unsat;
+                }
 
+                updateTargetPhases();
+
+                const std::size_t trailSize = trail.size();
+                const unsigned btLevel = analyze(learnt);
+                notifyConflict();
+                backtrack(btLevel);
+                const unsigned lbd = learn(learnt);
+                if (stable) {
+                    stableRestarts.onConflict(lbd, trailSize);
+                } else {
+                    restartPolicy.onConflict(lbd, trailSize);
+                }
+
+                bool restarted = true;
+                if (updateRegime()) {
+                    restartPolicy.reset();
+                    restart(assumptions.size());
+                } else if (stable ? stableRestarts.shouldRestart() : restartPolicy.shouldRestart()) {
+                    restart(assumptions.size());
+                    if (stable) {
+                        stableRestarts.onRestart();
+                    } else {
+                        restartPolicy.onRestart();
+                    }
+                } else {
+                    restarted = false;
+                }
+
+                if (restarted && learnts.size() >= maxLearnts) {
+                    backtrack(0);
+                    reduceLearnts();
+                    maxLearnts += maxLearnts / 10;
+                }
+
+                continue;
+            }
+
+            // assumptions are the first decisions
+            if (decisionLevel() < assumptions.size()) {
+                if (!decide(assumptions[decisionLevel()])) {
+                    backtrack(0);
+                    return SolveStatus::Unsat;
+                }
 
-   
+                continue;
+            }
+
+            const std::size_t open = numVariables - trail.size();
+            if (open == 0) {
+                return SolveStatus::Sat;
+            }
 
+            if (limitsReached()) {
+                return SolveStatus::Unknown;
+            }
+
+            decide(phases(pickBranchVariable(open)));
+        }
+    }
 
 } // sat
@@ -8,48 +8,414 @@
 #ifndef SOLVER_HPP
 #define SOLVER_HPP
 
-#include <memory>
+#include <span>
 #include <vector>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <variant>
+#include <array>
 
 #include "basic_structures.hpp"
 #include "Clause.hpp"
+#include "ClauseArena.hpp"
 #include "heuristics.hpp"
+#include "restarts.hpp"
+#include "util/enum.hpp"
 
 namespace sat {
-    /*
-     * These two types might be useful for your implementation. A shared pointer manages an object on the heap. It can
-     * be copied without copying the actual object. This can be useful if you want to access the same clause from
-     * multiple locations without copying it. Once all copies of the pointer have been destroyed, the actual object
-     * is also destroyed
+    /**
+     * @brief Branching heuristics available in the solver
+     */
+    PENUM(BranchingHeuristic, Vsids, Lrb, WeightedDegree, FirstVariable, JeroslowWang, Moms, Dlis)
+
+    /**
+     * @brief Result of a (budgeted) search
+     * @details Sat: satisfiable, the model is on the trail. Unsat: unsatisfiable (under the given assumptions).
+     * Restart: internal, the restart budget of an engine is exhausted. Unknown: resource limits reached, the next call
+     * with the same assumptions resumes the search
+     */
+    PENUM(SolveStatus, Sat, Unsat, Restart, Unknown)
+
+    /**
+     * @brief Resource limits of a single Solver::solveLimited call. Counted from the start of the call
+     */
+    struct SolveLimits {
+        std::uint64_t conflicts = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t decisions = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t propagations = std::numeric_limits<std::uint64_t>::max(); ///< number of propagated literals
+        std::chrono::milliseconds time = std::chrono::milliseconds::max();
+    };
+
+    /**
+     * @brief Search counters accumulated over the lifetime of a solver
      */
-    using ClausePointer = std::shared_ptr<Clause>;
-    using ConstClausePointer = std::shared_ptr<const Clause>;
-        enum class SolveStatus { Sat, Unsat, Restart };
+    struct SolveStatistics {
+        std::uint64_t conflicts = 0;
+        std::uint64_t decisions = 0;
+        std::uint64_t propagations = 0;
+        std::uint64_t restarts = 0;
+        std::uint64_t partialRestarts = 0; ///< restarts that kept a part of the trail
+        std::uint64_t reusedAssignments = 0; ///< assignments above the root level kept by restarts
+        std::uint64_t flips = 0; ///< flips of the local search
+    };
+
+    /**
+     * @brief Search engines available in the solver
+     * @details LocalSearch runs ProbSat first. A verified model is assigned directly, otherwise CDCL continues from
+     * the best assignment found (imported as saved and target phases, also if a fixed polarity is configured). The
+     * local search is stopped early once it stagnates, so that it costs little on structured and unsatisfiable
+     * instances
+     */
+    PENUM(SolveMode, Dpll, FirstVariable, Cdcl, Lookahead, LocalSearch)
+
+    /**
+     * @brief Search regimes of the CDCL engine
+     * @details Focused: restarts according to the restart policy, configured polarity. Stable: rare restarts
+     * (Luby with a large unit), target phases and slower decay of the heuristic scores. Alternating: switches between
+     * focused and stable search with geometrically growing conflict budgets. Stable and Alternating periodically
+     * rephase the saved phases (best, original, best, inverted, best, random, ...)
+     */
+    PENUM(SearchRegime, Focused, Stable, Alternating)
 
     /**
      * @brief Main solver class
+     * @details All engines work on a single solver instance. Branches are undone by backtracking on the assignment
+     * trail, the solver is never copied during search. The clause literals live once in the clause arena, the watch
+     * state consists of the watch lists and the order of the first two literals of each clause
      */
     class Solver {
+        static constexpr std::size_t StableRestartUnit = 1024;
+        static constexpr std::uint64_t ModeSwitchInterval = 1000; ///< conflicts of the first focused phase
+        static constexpr std::uint64_t RephaseInterval = 1000; ///< grows arithmetically with each rephase
+        static constexpr std::uint64_t LocalSearchMaxFlips = 1'000'000; ///< flip budget of the local search
+        static constexpr std::uint64_t LocalSearchStagnation = 200; ///< flips per variable without progress (> a try)
+        static constexpr double GarbageFraction = 0.2; ///< the clause arena is compacted above this share of garbage
+        static constexpr ClauseRef BinaryTag = ClauseArena::MaxRef + 1; ///< marks binary reasons (tag | other literal)
+
         // @TODO private members here
         unsigned numVariables;
         std::vector<TruthValue> model;
 
+        // value of each literal, indexed by literal id (1 true, -1 false, 0 unassigned). Mirrors model so that
+        // satisfied and falsified are a single load. Followed by GatherPadding zero bytes
+        std::vector<std::int8_t> literalValues;
+
+        // storage of all problem and learned clauses
+        ClauseArena arena;
+
         // All non-unit clauses stored once (no duplicates by copying)
-        std::vector<ClausePointer> clauses;
+        std::vector<ClauseRef> clauses;
 
-        // All unit literals (from unit clauses / propagation)
-        std::vector<Literal> unitLiterals;
+        /**
+         * Watch list entry. The blocker is a literal of the clause (initially the other watcher). If it is satisfied,
+         * the clause is skipped without accessing the clause memory
+         */
+        struct Watcher {
+            ClauseRef clause;
+            Literal blocker;
+        };
 
         // une Watch lists: for each literal id, store clauses currently watching this literal ( to be checked)
-        std::vector<std::vector<ClausePointer>> watchLists;
+        std::vector<std::vector<Watcher>> watchLists;
+
+        // binary clauses are not stored in the arena. implications[l] contains the literals implied by l (the other
+        // literals of the binary clauses containing ¬l)
+        std::vector<std::vector<Literal>> implications;
+
+        // binary problem clauses (learned binary clauses only live in the implication lists)
+        std::vector<std::array<Literal, 2>> binaries;
+
+        // Assignment trail: all assigned literals in chronological order
+        std::vector<Literal> trail;
+
+        // trailLimits[d] is the trail index at which decision level d + 1 starts
+        std::vector<std::size_t> trailLimits;
+
+        // decision level at which each variable was assigned
+        std::vector<unsigned> levels;
+
+        // index of the next trail literal to propagate
+        std::size_t qHead = 0;
+
+        // clause that implied each variable (NoClause for decisions and root units). Binary clauses are encoded as
+        // BinaryTag | id of the other literal
+        std::vector<ClauseRef> reasons;
+
+        // clause falsified by the last failed unit propagation. For binary conflicts, conflictLiteral is the literal
+        // that was propagated
+        ClauseRef conflictClause = NoClause;
+        Literal conflictLiteral = 0u;
+
+        /**
+         * Literals of a reason or conflict clause. The literals of binary clauses are stored in the view itself
+         */
+        class ClauseLiterals {
+            std::array<Literal, 2> binary{0u, 0u};
+            std::span<const Literal> clause;
+            bool isBinary;
+        public:
+            explicit ClauseLiterals(std::span<const Literal> clause) : clause(clause), isBinary(false) {}
+
+            ClauseLiterals(Literal first, Literal second) : binary{first, second}, isBinary(true) {}
+
+            const Literal *begin() const { return isBinary ? binary.data() : clause.data(); }
+
+            const Literal *end() const { return isBinary ? binary.data() + 2 : clause.data() + clause.size(); }
+        };
+
+        struct LearntClause {
+            ClauseRef clause;
+            unsigned lbd; ///< number of distinct decision levels in the clause when it was learned
+        };
+
+        // clauses derived by conflict analysis. They are also referenced by the watch lists
+        std::vector<LearntClause> learnts;
+        std::size_t maxLearnts = 0;
+
+        // size of the root level trail at the last removal of satisfied clauses
+        std::size_t simplifiedTrailSize = 0;
+
+        // scratch marks for conflict analysis
+        std::vector<char> seen;
+
+        // per decision level stamp of the last LBD computation that saw the level
+        std::vector<std::uint64_t> levelStamps;
+        std::uint64_t lbdStamp = 0;
+
+        // scratch literals of addClause (avoids an allocation per added clause)
+        std::vector<Literal> clauseBuffer;
+
+        // set when an added clause is violated by the root level assignment
+        bool rootConflict = false;
 
-        Solver clone() const;
         std::vector<Variable> lastConflictVars;
 
-        SolveStatus dpll(WeightedDegree &h, std::size_t &decisionBudget);        
-        bool dpllFirstVariable();
+        // engine used by solve() and branching scores, kept across calls
+        SolveMode mode = SolveMode::Dpll;
+        std::variant<VSIDS, LRB, WeightedDegree, FirstVariable, JeroslowWang, Moms, Dlis, Heuristic> brancher;
+        PhaseSelector phases;
+
+        SolveStatistics stats;
+        SolveLimits limits;
+
+        // limits of the running call (if it is a solveLimited call)
+        bool limited = false;
+        SolveStatistics callStart;
+        std::optional<std::chrono::steady_clock::time_point> deadline;
+
+        // state of a search that ran out of budget and can be resumed
+        struct SuspendedSearch {
+            bool active = false;
+            SolveMode mode = SolveMode::Dpll;
+            std::vector<Literal> assumptions;
+        } suspended;
+
+        // restart schedule of the running (or suspended) search
+        std::variant<LubyRestarts, GeometricRestarts, GlucoseRestarts, NoRestarts> restartPolicy;
+
+        // stable / focused search of the CDCL engine
+        SearchRegime regime = SearchRegime::Focused;
+        PhaseMode polarity = PhaseMode::Saved; ///< polarity of focused search
+        bool stable = false;
+        LubyRestarts stableRestarts{StableRestartUnit};
+        std::uint64_t switchInterval = 0;
+        std::uint64_t nextSwitch = 0;
+        std::uint64_t nextRephase = 0;
+        std::size_t rephases = 0;
+
+        struct DecisionFrame {
+            Literal decision; ///< decision literal of the level
+            bool flipped; ///< whether the decision is already the second branch
+        };
+
+        // DPLL decision stack. Frame i corresponds to decision level i + 1
+        std::vector<DecisionFrame> decisions;
+
+        /**
+         * Iterative DPLL search with chronological backtracking on the decision stack
+         * @tparam H heuristic type. Conflicts are reported to the heuristic if it has a member onConflict
+         * @tparam R restart policy type
+         * @param h branching heuristic
+         * @param restartPolicy decides when the search returns SolveStatus::Restart (LBD = levels of the conflict)
+         * @return Sat (model on the trail), Unsat or Restart (caller must backtrack to level 0)
+         */
+        template<heuristic H, restart_policy R>
+        SolveStatus dpll(H &h, R &restartPolicy, std::span<const Literal> assumptions);
+
+        /**
+         * CDCL search loop, restarts and learned clause reduction included
+         * @tparam R restart policy type
+         * @param restartPolicy decides when to restart (fed with the LBD of each learned clause)
+         * @param resume whether a suspended search is continued
+         * @return Sat (model on the trail), Unsat or Unknown (resource limits reached)
+         */
+        template<restart_policy R>
+        SolveStatus cdcl(R &restartPolicy, std::span<const Literal> assumptions, bool resume);
+
+        SolveStatus search(std::span<const Literal> assumptions, bool useLimits);
+
+        /*
+         * Notifications forwarded to the branching heuristic (if it supports them)
+         */
+        Variable pickBranchVariable(std::size_t numOpen);
+        void notifyAssign(Variable x);
+        void notifyUnassign(Variable x);
+        void notifyConflict();
+        void notifyRestart();
+        void notifyClauseAdded(std::span<const Literal> clause);
+        void notifyClauseRemoved(std::span<const Literal> clause);
+
+        /**
+         * Offers the conflict free part of the trail (all levels below the current one) as target phases
+         */
+        void updateTargetPhases();
+
+        /**
+         * Whether the resource limits of the running call are exhausted
+         */
+        bool limitsReached() const;
+
+        /**
+         * Resets the search to the root level (also drops a suspended search)
+         */
+        void resetSearch();
+
+        /**
+         * Sets up the search regime at the beginning of a search
+         */
+        void initRegime();
+
+        /**
+         * Switches between focused and stable search and rephases when the respective conflict budgets are exhausted
+         * @return true if the search mode changed (the caller should restart)
+         */
+        bool updateRegime();
+
+        void setStable(bool stableMode);
+
+        /**
+         * Polarity of focused search. The LocalSearch engine uses saved phases instead of a fixed or random sign so
+         * that CDCL continues from the imported assignment
+         */
+        PhaseMode focusedPolarity() const;
+
+        /**
+         * Level to which a restart backtracks when reusing the trail: decision levels are kept as long as their
+         * decision variable has a higher heuristic score than every open variable, since the heuristic would pick the
+         * same decisions again. Requires the heuristic to provide score(Variable), otherwise only the first keepLevels
+         * levels are kept
+         * @param keepLevels number of levels that are always kept (assumptions)
+         */
+        unsigned reuseTrailLevel(std::size_t keepLevels) const;
+
+        /**
+         * Partial restart: backtracks to reuseTrailLevel, updates the restart statistics and removes satisfied clauses
+         * @param keepLevels number of levels that are always kept (assumptions)
+         */
+        void restart(std::size_t keepLevels);
+
+        SolveStatus runDpll(std::span<const Literal> assumptions, bool resume);
+        SolveStatus runFirstVariable(std::span<const Literal> assumptions, bool resume);
+        SolveStatus runCdcl(std::span<const Literal> assumptions, bool resume);
+        SolveStatus runLookahead(std::span<const Literal> assumptions, bool resume);
+        SolveStatus runLocalSearch(std::span<const Literal> assumptions, bool resume);
 
+        /**
+         * Tentatively assigns a literal on a new decision level, propagates it and undoes everything again
+         * @param l literal to probe
+         * @param implied output: literals assigned by the probe (including l), empty if l failed
+         * @return number of literals assigned by the probe or std::nullopt if l is a failed literal
+         */
+        std::optional<std::size_t> probe(Literal l, std::vector<Literal> &implied);
+
+        /**
+         * Lookahead on all open variables: both phases of each variable are probed. Failed literals are fixed on the
+         * current decision level, so are literals implied by both phases of a variable. The variable maximizing
+         * 1024 * r(x) * r(¬x) + r(x) + r(¬x) (r = number of implied literals) is selected, its phase with the larger
+         * reduction is branched on first
+         * @param branch output: branching literal. Empty if literals were fixed (the node must be re-examined)
+         * @return false if fixing literals resulted in a conflict, true otherwise
+         */
+        bool lookahead(std::optional<Literal> &branch);
+
+        bool assign(Literal l, ClauseRef reason);
+
+        static bool isBinary(ClauseRef reason);
+
+        static constexpr std::size_t MaxKernelSize = 8; ///< clauses up to this size use a size specialized kernel
+        static constexpr std::size_t LongKernelWidth = 8; ///< literals checked at once by the long clause kernel
+        static constexpr std::size_t GatherPadding = 3; ///< literalValues is padded for 4 byte gathers
+
+        /**
+         * Searches a literal of the clause that is neither a watcher (position 0 and 1) nor falsified
+         * @tparam N clause size (3 to MaxKernelSize)
+         * @param lits literals of the clause
+         * @return position of the literal, lits.size() if there is none
+         */
+        template<std::size_t N>
+        std::size_t findReplacement(std::span<const Literal, N> lits) const;
+
+        /**
+         * Replacement watcher search for clauses longer than MaxKernelSize. With AVX2, the values of LongKernelWidth
+         * literals are gathered from literalValues at once, otherwise (and for the remainder) the literals are checked
+         * one by one
+         * @param lits literals of the clause
+         * @return position of the literal, lits.size() if there is none
+         */
+        std::size_t findLongReplacement(std::span<const Literal> lits) const;
+
+        /**
+         * Selects the replacement watcher kernel by the clause size (ternary, small-k up to MaxKernelSize, long)
+         */
+        std::size_t findReplacement(std::span<const Literal> lits) const;
+
+        /**
+         * Literals of a reason or conflict clause
+         * @param reason clause reference (possibly a binary reason)
+         * @param implied literal implied by the reason (for binary clauses, the propagated literal for conflicts)
+         */
+        ClauseLiterals literals(ClauseRef reason, Literal implied) const;
+
+        /**
+         * 1UIP conflict analysis of conflictClause
+         * @param learnt output: learned clause with the asserting literal first and a literal of the backjump level
+         * second
+         * @return decision level to backjump to
+         */
+        unsigned analyze(std::vector<Literal> &learnt);
+
+        /**
+         * Removes learned literals that are implied by other literals of the learned clause
+         */
+        void minimize(std::vector<Literal> &learnt) const;
+
+        unsigned computeLbd(std::span<const Literal> clause);
+
+        /**
+         * Adds a learned clause to the watch lists and assigns its asserting literal. Must be called after
+         * backjumping
+         * @return LBD of the learned clause
+         */
+        unsigned learn(std::vector<Literal> learnt);
+
+        /**
+         * Deletes the less useful half of the learned clauses (highest LBD first). Must be called on level 0
+         */
+        void reduceLearnts();
 
+        /**
+         * Deletes all clauses that are satisfied by the root level assignment (if the root level grew since the last
+         * call). Removed problem clauses are reported to the branching heuristic
+         */
+        void removeSatisfied();
+
+        /**
+         * Compacts the clause arena if more than GarbageFraction of it is occupied by deleted clauses. Relocates all
+         * clause references (clause lists, watch lists and reasons)
+         */
+        void collectGarbage();
 
     public:
 
@@ -75,6 +441,8 @@ namespace sat {
          * @param clause The clause to add
          * @return bool true if clause was successfully added, false if clause is empty or unit and violates the current
          * model
+         * @note May be called between two solve calls. The search state is reset to the root level first (which
+         * discards the model of the last call), learned clauses and heuristic scores are kept
          */
         bool addClause(Clause clause);
 
@@ -113,26 +481,120 @@ namespace sat {
         bool assign(Literal l);
 
         /**
-         * Does the unit propagation.
+         * Does the unit propagation. Propagation resumes at the queue head, so each call only visits the literals that
+         * were assigned since the previous call. After a conflict, the solver has to backtrack before propagating again
          * @return true if unit propagation was successful, false otherwise
          */
         bool unitPropagate();
-         /**
-         * Solves the SAT instance using a simple DPLL loop (FirstVariable heuristic)
-         * @return true if satisfiable, false otherwise
+
+        /**
+         * Opens a new decision level and assigns the given literal as its decision. If the literal already holds, the
+         * level stays empty (used for assumptions)
+         * @param l decision literal
+         * @return false if literal is already falsified (no level is opened), true otherwise
          */
-        bool solve();
+        bool decide(Literal l);
 
+        /**
+         * Gets the current decision level (0 if no decision has been made)
+         * @return number of open decision levels
+         */
+        unsigned decisionLevel() const;
+
+        /**
+         * Undoes all assignments made above the given decision level
+         * @param level decision level to return to
+         */
+        void backtrack(unsigned level);
+
+        /**
+         * Selects the search engine used by solve()
+         * @param solveMode the engine
+         */
+        void setSolveMode(SolveMode solveMode);
+
+        /**
+         * Selects the polarity strategy for decisions. Resets all saved and target phases
+         * @param phaseMode polarity strategy
+         * @param positiveDefault sign for variables without saved / target phase
+         */
+        void setPolarity(PhaseMode phaseMode, bool positiveDefault = false);
+
+        /**
+         * Selects the search regime of the Cdcl engine (Focused by default)
+         * @param searchRegime the regime
+         */
+        void setSearchRegime(SearchRegime searchRegime);
+
+        /**
+         * Selects the restart policy of the Dpll and Cdcl engines (Luby by default)
+         * @param strategy the policy
+         */
+        void setRestartPolicy(RestartStrategy strategy);
+
+        /**
+         * Selects the branching heuristic of the Dpll and Cdcl engines. Resets all heuristic scores
+         * @param type the heuristic
+         */
+        void setHeuristic(BranchingHeuristic type);
+
+        /**
+         * Uses a custom branching heuristic in the Dpll and Cdcl engines. The solver invokes the callbacks of the
+         * incremental heuristic interface supported by the wrapped heuristic (see sat::incremental_heuristic)
+         * @param custom the heuristic
+         * @throws BadHeuristicCall if the wrapper is empty
+         */
+        void setHeuristic(Heuristic custom);
+
+        /**
+         * Solves the SAT instance under the given assumptions using the selected engine (see setSolveMode).
+         * The solver can be called repeatedly: clauses can be added between calls, learned clauses and heuristic
+         * scores are reused.
+         * @param assumptions literals that must hold in the model (only for this call)
+         * @return true if satisfiable under the assumptions (model is available through val() and getUnitLiterals()),
+         * false otherwise
+         */
+        bool solve(std::span<const Literal> assumptions = {});
+
+        /**
+         * Sets the resource limits used by solveLimited
+         * @param solveLimits limits per call
+         */
+        void setLimits(const SolveLimits &solveLimits);
+
+        /**
+         * Like solve, but stops with SolveStatus::Unknown once one of the limits (see setLimits) is reached. The
+         * search state is kept in this case, and the next solve or solveLimited call with the same assumptions
+         * continues where this one stopped.
+         * @param assumptions literals that must hold in the model (only for this call)
+         * @return Sat, Unsat or Unknown
+         */
+        SolveStatus solveLimited(std::span<const Literal> assumptions = {});
+
+        /**
+         * Gets the search counters
+         * @return statistics accumulated over all calls
+         */
+        const SolveStatistics &getStatistics() const;
+
+        /**
+         * Gets all assigned literals in assignment order
+         * @return the assignment trail
+         */
         std::vector<Literal> getUnitLiterals() const;
+
         /**
          * Solves the SAT instance using a simple DPLL loop (FirstVariable heuristic)
          * @return true if satisfiable, false otherwise
          */
         bool solveFirstVariable();
 
-
-
-
+        /**
+         * Solves the SAT instance using conflict driven clause learning (1UIP learning, non-chronological
+         * backjumping, restarts according to the restart policy)
+         * @return true if satisfiable, false otherwise
+         */
+        bool solveCdcl();
     };
 } // sat
 
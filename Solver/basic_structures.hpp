@@ -8,8 +8,10 @@
 #ifndef BASIC_STRUCTURES_HPP
 #define BASIC_STRUCTURES_HPP
 
-/* These are only the declarations of the classes and their members
- * @TODO implementation in basic_structures.cpp
+#include <cstdint>
+
+/* All members are defined inline (constexpr), so that literal arithmetic inlines into the propagation loops of all
+ * translation units
  */
 
 namespace sat {
@@ -17,8 +19,8 @@ namespace sat {
     /**
      * @brief Represents a truth value
      */
-    enum class TruthValue {
-        False = -1, ///< variable is true
+    enum class TruthValue : std::int8_t {
+        False = -1, ///< variable is false
         Undefined = 0, ///< variable is unassigned
         True = 1 ///< variable is true
     };
@@ -27,26 +29,29 @@ namespace sat {
      * @brief Structure representing a binary variable in a CNF-SAT problem
      */
     class  Variable {
-        //@TODO Private members here
         unsigned val;
     public:
         /**
          * CTor
          * @param val variable number (name of the variable)
          */
-        Variable(unsigned val);
+        constexpr Variable(unsigned val) : val(val) {}
 
         /**
          * gets the underlying variable number
          * @return
          */
-        unsigned get() const;
+        constexpr unsigned get() const {
+            return val;
+        }
 
         /**
          * Compares the underlying variable identifier
          * @return True if both variables are the same (have the same identifier)
          */
-        bool operator==(Variable other) const;
+        constexpr bool operator==(Variable other) const {
+            return val == other.val;
+        }
     };
 
     /**
@@ -55,7 +60,6 @@ namespace sat {
      * A literal of variable x is either x or ¬x
      */
     class Literal {
-        //@TODO Private members here
         unsigned val;
     public:
         /**
@@ -64,31 +68,41 @@ namespace sat {
          * identifier stands for a negative literal, an odd one for a positive
          * see also sat::pos and sat::neg
          */
-        Literal(unsigned val);
+        constexpr Literal(unsigned val) : val(val) {}
 
         /**
          * Gets the underlying literal identifier
          * @return the literal identifier
          */
-        unsigned get() const;
+        constexpr unsigned get() const {
+            return val;
+        }
 
         /**
          * Gets the negated literal
          * @return the negated literal
          */
-        Literal negate() const;
+        constexpr Literal negate() const {
+            // flip last bit: even <-> odd (negative <-> positive)
+            return Literal(val ^ 1u);
+        }
 
         /**
          * Gets the sign of the literal
          * @return -1 if negative literal, +1 else
          */
-        short sign() const;
+        constexpr short sign() const {
+            // even => negative => -1, odd => positive => +1
+            return (val & 1u) ? short(1) : short(-1);
+        }
 
         /**
          * Compares underlying literal identifiers
          * @return True if both literals are exactly the same (sign and variable)
          */
-        bool operator==(Literal) const;
+        constexpr bool operator==(Literal other) const {
+            return val == other.val;
+        }
     };
 
     /**
@@ -96,21 +110,30 @@ namespace sat {
      * @param x Variable for which to create the literal
      * @return positive literal of x
      */
-    Literal pos(Variable x);
+    constexpr Literal pos(Variable x) {
+        // positive literal => odd id = 2*var + 1
+        return Literal(2u * x.get() + 1u);
+    }
 
     /**
      * Creates the negative Literal for a given variable
      * @param x Variable for which to create the literal
      * @return negative literal of x
      */
-    Literal neg(Variable x);
+    constexpr Literal neg(Variable x) {
+        // negative literal => even id = 2*var
+        return Literal(2u * x.get());
+    }
 
     /**
      * Gets the corresponding Variable of a Literal
      * @param l
      * @return Variable of given Literal
      */
-    Variable var(Literal l);
+    constexpr Variable var(Literal l) {
+        // var id = lit id / 2
+        return Variable(l.get() / 2u);
+    }
 
 }
 
@@ -5,9 +5,12 @@
 */
 
 #include <Iterators.hpp>
+#include <algorithm>
+#include <cmath>
 
 #include "heuristics.hpp"
 #include "util/exception.hpp"
+#include "util/random.hpp"
 
 namespace sat {
 
@@ -21,12 +24,44 @@ namespace sat {
         throw std::runtime_error("Found no open variable");
     }
 
-    Variable Heuristic::operator()(const std::vector<TruthValue> &values, std::size_t numOpenVariables) const {
+    detail::HeuristicCallableBase &Heuristic::get() const {
         if (nullptr == impl) {
             throw BadHeuristicCall("heuristic wrapper does not contain a heuristic");
         }
 
-        return impl->invoke(values, numOpenVariables);
+        return *impl;
+    }
+
+    Variable Heuristic::operator()(const std::vector<TruthValue> &values, std::size_t numOpenVariables) const {
+        return get().invoke(values, numOpenVariables);
+    }
+
+    void Heuristic::onAssign(Variable x) {
+        get().onAssign(x);
+    }
+
+    void Heuristic::onUnassign(Variable x) {
+        get().onUnassign(x);
+    }
+
+    void Heuristic::onConflict(const std::vector<Variable> &vars) {
+        get().onConflict(vars);
+    }
+
+    void Heuristic::onRestart() {
+        get().onRestart();
+    }
+
+    void Heuristic::onModeSwitch(bool stable) {
+        get().onModeSwitch(stable);
+    }
+
+    void Heuristic::onClauseAdded(std::span<const Literal> clause) {
+        get().onClauseAdded(clause);
+    }
+
+    void Heuristic::onClauseRemoved(std::span<const Literal> clause) {
+        get().onClauseRemoved(clause);
     }
 
     bool Heuristic::isValid() const {
@@ -69,6 +104,284 @@ namespace sat {
         }
     }
 
+    void WeightedDegree::onRestart() {
+        decay();
+    }
+
+    double WeightedDegree::score(Variable x) const {
+        return weight[x.get()];
+    }
+
+    VSIDS::VSIDS(std::size_t numVars, double decay) : order(numVars), decayFactor(decay), stableDecay(decay) {}
+
+    Variable VSIDS::operator()(const std::vector<TruthValue> &model, std::size_t) {
+        while (!order.empty()) {
+            Variable x = order.pop();
+            if (model[x.get()] == TruthValue::Undefined) {
+                return x;
+            }
+        }
+
+        throw std::runtime_error("Found no open variable");
+    }
+
+    void VSIDS::onConflict(const std::vector<Variable> &vars) {
+        for (auto x : vars) {
+            order.setScore(x, order.score(x) + increment);
+        }
 
+        increment /= decayFactor;
+        if (increment > 1e100) {
+            order.scale(1e-100);
+            increment *= 1e-100;
+        }
+    }
 
+    void VSIDS::onUnassign(Variable x) {
+        order.insert(x);
+    }
+
+    void VSIDS::onModeSwitch(bool stable) {
+        decayFactor = stable ? stableDecay : FocusedDecay;
+    }
+
+    double VSIDS::score(Variable x) const {
+        return order.score(x);
+    }
+
+    LRB::LRB(std::size_t numVars) : order(numVars), assignedAt(numVars, 0), participated(numVars, 0) {}
+
+    Variable LRB::operator()(const std::vector<TruthValue> &model, std::size_t) {
+        while (!order.empty()) {
+            Variable x = order.pop();
+            if (model[x.get()] == TruthValue::Undefined) {
+                return x;
+            }
+        }
+
+        throw std::runtime_error("Found no open variable");
+    }
+
+    void LRB::onAssign(Variable x) {
+        assignedAt[x.get()] = conflicts;
+        participated[x.get()] = 0;
+    }
+
+    void LRB::onUnassign(Variable x) {
+        const std::uint64_t interval = conflicts - assignedAt[x.get()];
+        if (interval > 0) {
+            const double reward = static_cast<double>(participated[x.get()]) / static_cast<double>(interval);
+            order.setScore(x, (1 - stepSize) * order.score(x) + stepSize * reward);
+        }
+
+        order.insert(x);
+    }
+
+    void LRB::onConflict(const std::vector<Variable> &vars) {
+        for (auto x : vars) {
+            ++participated[x.get()];
+        }
+
+        ++conflicts;
+        stepSize = std::max(MinStepSize, stepSize - StepSizeDecrement);
+    }
+
+    double LRB::score(Variable x) const {
+        return order.score(x);
+    }
+
+    LiteralOccurrences::LiteralOccurrences(std::size_t numVars)
+        : count(2 * numVars, 0), binary(2 * numVars, 0), ternary(2 * numVars, 0), jeroslowWang(2 * numVars, 0) {}
+
+    void LiteralOccurrences::add(std::span<const Literal> clause) {
+        const double weight = std::ldexp(1.0, -static_cast<int>(clause.size()));
+        for (Literal l : clause) {
+            ++count[l.get()];
+            binary[l.get()] += clause.size() == 2;
+            ternary[l.get()] += clause.size() == 3;
+            jeroslowWang[l.get()] += weight;
+        }
+    }
+
+    void LiteralOccurrences::remove(std::span<const Literal> clause) {
+        const double weight = std::ldexp(1.0, -static_cast<int>(clause.size()));
+        for (Literal l : clause) {
+            --count[l.get()];
+            binary[l.get()] -= clause.size() == 2;
+            ternary[l.get()] -= clause.size() == 3;
+            jeroslowWang[l.get()] = std::max(0.0, jeroslowWang[l.get()] - weight);
+        }
+    }
+
+    namespace detail {
+        double JeroslowWangScore::operator()(const LiteralOccurrences &occ, Variable x) const {
+            return occ.jeroslowWang[pos(x).get()] + occ.jeroslowWang[neg(x).get()];
+        }
+
+        double MomsScore::operator()(const LiteralOccurrences &occ, Variable x) const {
+            constexpr double K = 1 << 10;
+            auto moms = [x](const std::vector<unsigned> &f) {
+                const double p = f[pos(x).get()];
+                const double n = f[neg(x).get()];
+                return (p + n) * K + p * n;
+            };
+
+            // lexicographic: binary clauses first
+            return moms(occ.binary) * 1e9 + moms(occ.ternary);
+        }
+
+        double DlisScore::operator()(const LiteralOccurrences &occ, Variable x) const {
+            return std::max(occ.count[pos(x).get()], occ.count[neg(x).get()]);
+        }
+    }
+
+    template<typename Score>
+    OccurrenceHeuristic<Score>::OccurrenceHeuristic(std::size_t numVars) : occurrences(numVars), order(numVars) {}
+
+    template<typename Score>
+    void OccurrenceHeuristic<Score>::update(std::span<const Literal> clause) {
+        for (Literal l : clause) {
+            order.setScore(var(l), scoring(occurrences, var(l)));
+        }
+    }
+
+    template<typename Score>
+    Variable OccurrenceHeuristic<Score>::operator()(const std::vector<TruthValue> &model, std::size_t) {
+        while (!order.empty()) {
+            Variable x = order.pop();
+            if (model[x.get()] == TruthValue::Undefined) {
+                return x;
+            }
+        }
+
+        throw std::runtime_error("Found no open variable");
+    }
+
+    template<typename Score>
+    void OccurrenceHeuristic<Score>::onClauseAdded(std::span<const Literal> clause) {
+        occurrences.add(clause);
+        update(clause);
+    }
+
+    template<typename Score>
+    void OccurrenceHeuristic<Score>::onClauseRemoved(std::span<const Literal> clause) {
+        occurrences.remove(clause);
+        update(clause);
+    }
+
+    template<typename Score>
+    void OccurrenceHeuristic<Score>::onUnassign(Variable x) {
+        order.insert(x);
+    }
+
+    template<typename Score>
+    double OccurrenceHeuristic<Score>::score(Variable x) const {
+        return order.score(x);
+    }
+
+    template<typename Score>
+    const LiteralOccurrences &OccurrenceHeuristic<Score>::getOccurrences() const {
+        return occurrences;
+    }
+
+    template class OccurrenceHeuristic<detail::JeroslowWangScore>;
+    template class OccurrenceHeuristic<detail::MomsScore>;
+    template class OccurrenceHeuristic<detail::DlisScore>;
+
+    PhaseSelector::PhaseSelector(std::size_t numVars, PhaseMode mode, bool positiveDefault)
+        : mode(mode), positiveDefault(positiveDefault), savedPhases(numVars, TruthValue::Undefined),
+          targetPhases(numVars, TruthValue::Undefined) {}
+
+    Literal PhaseSelector::operator()(Variable x) const {
+        auto fromValue = [this, x](TruthValue v) {
+            if (v == TruthValue::Undefined) {
+                return positiveDefault ? pos(x) : neg(x);
+            }
+
+            return v == TruthValue::True ? pos(x) : neg(x);
+        };
+
+        switch (mode) {
+            case PhaseMode::Negative:
+                return neg(x);
+            case PhaseMode::Positive:
+                return pos(x);
+            case PhaseMode::Saved:
+                return fromValue(savedPhases[x.get()]);
+            case PhaseMode::Random:
+                return RNG::get().random_int(0, 1) ? pos(x) : neg(x);
+            case PhaseMode::Target:
+                if (targetPhases[x.get()] != TruthValue::Undefined) {
+                    return fromValue(targetPhases[x.get()]);
+                }
+
+                return fromValue(savedPhases[x.get()]);
+        }
+
+        throw std::runtime_error("unknown phase mode");
+    }
+
+    void PhaseSelector::onUnassign(Literal l) {
+        savedPhases[var(l).get()] = l.sign() > 0 ? TruthValue::True : TruthValue::False;
+    }
+
+    void PhaseSelector::updateTarget(std::span<const Literal> assignment) {
+        if (assignment.size() <= bestTrailSize) {
+            return;
+        }
+
+        bestTrailSize = assignment.size();
+        std::ranges::fill(targetPhases, TruthValue::Undefined);
+        for (Literal l : assignment) {
+            targetPhases[var(l).get()] = l.sign() > 0 ? TruthValue::True : TruthValue::False;
+        }
+    }
+
+    void PhaseSelector::resetTarget() {
+        bestTrailSize = 0;
+        std::ranges::fill(targetPhases, TruthValue::Undefined);
+    }
+
+    void PhaseSelector::rephase(Rephase kind) {
+        const TruthValue defaultValue = positiveDefault ? TruthValue::True : TruthValue::False;
+        switch (kind) {
+            case Rephase::Original:
+                std::ranges::fill(savedPhases, defaultValue);
+                break;
+            case Rephase::Inverted:
+                std::ranges::fill(savedPhases, positiveDefault ? TruthValue::False : TruthValue::True);
+                break;
+            case Rephase::Random:
+                for (auto &phase : savedPhases) {
+                    phase = RNG::get().random_int(0, 1) ? TruthValue::True : TruthValue::False;
+                }
+                break;
+            case Rephase::Best:
+                for (std::size_t x = 0; x < savedPhases.size(); ++x) {
+                    if (targetPhases[x] != TruthValue::Undefined) {
+                        savedPhases[x] = targetPhases[x];
+                    }
+                }
+                break;
+        }
+
+        resetTarget();
+    }
+
+    void PhaseSelector::importPhases(std::span<const Literal> assignment) {
+        for (Literal l : assignment) {
+            savedPhases[var(l).get()] = l.sign() > 0 ? TruthValue::True : TruthValue::False;
+        }
+
+        resetTarget();
+        updateTarget(assignment);
+    }
+
+    void PhaseSelector::setMode(PhaseMode phaseMode) {
+        mode = phaseMode;
+    }
+
+    PhaseMode PhaseSelector::getMode() const {
+        return mode;
+    }
 }
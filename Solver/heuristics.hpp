@@ -10,9 +10,14 @@
 
 #include <vector>
 #include <memory>
+#include <span>
+#include <cstdint>
 
 #include "basic_structures.hpp"
+#include "Clause.hpp"
 #include "util/concepts.hpp"
+#include "util/enum.hpp"
+#include "util/ActivityHeap.hpp"
 
 namespace sat {
     /**
@@ -23,6 +28,78 @@ namespace sat {
     template<typename H>
     concept heuristic = concepts::callable_r<H, Variable, const std::vector<TruthValue>, std::size_t>;
 
+    /**
+     * Concept modelling the incremental heuristic interface. In addition to the selection operator, an incremental
+     * heuristic is notified by the solver whenever a variable is assigned (onAssign) or unassigned (onUnassign), after
+     * each conflict with the variables involved (onConflict) and on restarts (onRestart). This allows heuristics to
+     * maintain their own index of open variables instead of scanning the model at every decision. All callbacks are
+     * optional for the solver and the wrappers: missing callbacks are simply not invoked (see detail::notifyAssign etc.)
+     * @note occurrence based heuristics additionally use onClauseAdded(std::span<const Literal>) and
+     * onClauseRemoved(std::span<const Literal>) (the literals of the clause). onModeSwitch(bool stable) is called when
+     * the solver switches between focused and stable search
+     */
+    template<typename H>
+    concept incremental_heuristic = heuristic<H> && requires(H &h, Variable x, const std::vector<Variable> &vars) {
+        h.onAssign(x);
+        h.onUnassign(x);
+        h.onConflict(vars);
+        h.onRestart();
+    };
+
+    namespace detail {
+        /*
+         * Invoke the respective callback of a heuristic if it supports it, do nothing otherwise
+         */
+        template<typename H>
+        void notifyAssign(H &h, Variable x) {
+            if constexpr (requires { h.onAssign(x); }) {
+                h.onAssign(x);
+            }
+        }
+
+        template<typename H>
+        void notifyUnassign(H &h, Variable x) {
+            if constexpr (requires { h.onUnassign(x); }) {
+                h.onUnassign(x);
+            }
+        }
+
+        template<typename H>
+        void notifyConflict(H &h, const std::vector<Variable> &vars) {
+            if constexpr (requires { h.onConflict(vars); }) {
+                h.onConflict(vars);
+            }
+        }
+
+        template<typename H>
+        void notifyRestart(H &h) {
+            if constexpr (requires { h.onRestart(); }) {
+                h.onRestart();
+            }
+        }
+
+        template<typename H>
+        void notifyModeSwitch(H &h, bool stable) {
+            if constexpr (requires { h.onModeSwitch(stable); }) {
+                h.onModeSwitch(stable);
+            }
+        }
+
+        template<typename H>
+        void notifyClauseAdded(H &h, std::span<const Literal> clause) {
+            if constexpr (requires { h.onClauseAdded(clause); }) {
+                h.onClauseAdded(clause);
+            }
+        }
+
+        template<typename H>
+        void notifyClauseRemoved(H &h, std::span<const Literal> clause) {
+            if constexpr (requires { h.onClauseRemoved(clause); }) {
+                h.onClauseRemoved(clause);
+            }
+        }
+    }
+
     /**
      * @brief Variable selection strategy that selects the first unassigned variable
      */
@@ -48,6 +125,20 @@ namespace sat {
             HeuristicCallableBase &operator=(const HeuristicCallableBase &) = default;
 
             virtual Variable invoke(const std::vector<TruthValue> &, std::size_t) = 0;
+
+            virtual void onAssign(Variable) = 0;
+
+            virtual void onUnassign(Variable) = 0;
+
+            virtual void onConflict(const std::vector<Variable> &) = 0;
+
+            virtual void onRestart() = 0;
+
+            virtual void onModeSwitch(bool) = 0;
+
+            virtual void onClauseAdded(std::span<const Literal>) = 0;
+
+            virtual void onClauseRemoved(std::span<const Literal>) = 0;
         };
 
         /**
@@ -64,14 +155,49 @@ namespace sat {
             Variable invoke(const std::vector<TruthValue> &values, std::size_t numOpenVariables) override {
                 return impl(values, numOpenVariables);
             }
+
+            void onAssign(Variable x) override {
+                notifyAssign(impl, x);
+            }
+
+            void onUnassign(Variable x) override {
+                notifyUnassign(impl, x);
+            }
+
+            void onConflict(const std::vector<Variable> &vars) override {
+                notifyConflict(impl, vars);
+            }
+
+            void onRestart() override {
+                notifyRestart(impl);
+            }
+
+            void onModeSwitch(bool stable) override {
+                notifyModeSwitch(impl, stable);
+            }
+
+            void onClauseAdded(std::span<const Literal> clause) override {
+                notifyClauseAdded(impl, clause);
+            }
+
+            void onClauseRemoved(std::span<const Literal> clause) override {
+                notifyClauseRemoved(impl, clause);
+            }
         };
     }
 
     /**
      * @brief Type erasure heuristic wrapper that can hold any type of heuristic
+     * @details The wrapper models incremental_heuristic: callbacks are forwarded to the stored heuristic if it
+     * supports them
      */
     class Heuristic {
         std::unique_ptr<detail::HeuristicCallableBase> impl;
+
+        /**
+         * @throws BadHeuristicCall if the wrapper is empty
+         */
+        detail::HeuristicCallableBase &get() const;
     public:
         /**
          * Default Ctor. Constructs an empty heuristic that must not be called
@@ -90,6 +216,20 @@ namespace sat {
 
         Variable operator()(const std::vector<TruthValue> &values, std::size_t numOpenVariables) const;
 
+        void onAssign(Variable x);
+
+        void onUnassign(Variable x);
+
+        void onConflict(const std::vector<Variable> &vars);
+
+        void onRestart();
+
+        void onModeSwitch(bool stable);
+
+        void onClauseAdded(std::span<const Literal> clause);
+
+        void onClauseRemoved(std::span<const Literal> clause);
+
         /**
          * Whether the wrapper holds a valid heuristic
          * @return true if heuristic wrapper is valid, false otherwise
@@ -99,6 +239,7 @@ namespace sat {
 
     /**
      * @brief Wrapper for heuristics that do not support move construction or assignment
+     * @details Callbacks of the incremental interface are available if the wrapped heuristic supports them
      * @tparam H heuristic type
      */
     template<heuristic H>
@@ -116,6 +257,36 @@ namespace sat {
         Variable operator()(const std::vector<TruthValue> &values, std::size_t numOpenVariables) const {
             return h->operator()(values, numOpenVariables);
         }
+
+        void onAssign(Variable x) requires requires(H &impl) { impl.onAssign(x); } {
+            h->onAssign(x);
+        }
+
+        void onUnassign(Variable x) requires requires(H &impl) { impl.onUnassign(x); } {
+            h->onUnassign(x);
+        }
+
+        void onConflict(const std::vector<Variable> &vars) requires requires(H &impl) { impl.onConflict(vars); } {
+            h->onConflict(vars);
+        }
+
+        void onRestart() requires requires(H &impl) { impl.onRestart(); } {
+            h->onRestart();
+        }
+
+        void onModeSwitch(bool stable) requires requires(H &impl) { impl.onModeSwitch(stable); } {
+            h->onModeSwitch(stable);
+        }
+
+        void onClauseAdded(std::span<const Literal> clause)
+            requires requires(H &impl) { impl.onClauseAdded(clause); } {
+            h->onClauseAdded(clause);
+        }
+
+        void onClauseRemoved(std::span<const Literal> clause)
+            requires requires(H &impl) { impl.onClauseRemoved(clause); } {
+            h->onClauseRemoved(clause);
+        }
     };
 
         /**
@@ -139,12 +310,263 @@ namespace sat {
 
         
         void decay();
+
+        /**
+         * Restart callback, decays the weights
+         */
+        void onRestart();
+
+        double score(Variable x) const;
     };
+    /**
+     * @brief Dynamic heuristic: exponential VSIDS
+     * @details
+     * Keeps an activity per variable in a binary heap. On conflicts, the activities of the involved variables are
+     * increased by a bump increment that itself grows by 1 / decay after every conflict, so that recent conflicts
+     * weigh more (equivalent to decaying all activities, but O(1)). Activities are rescaled when they become too
+     * large. Next decision variable = unassigned variable with maximum activity (tie -> smallest id) in O(log n).
+     * The heap is cleaned lazily: assigned variables are only dropped when they reach the top. Unassigned variables
+     * must be reported through onUnassign.
+     */
+    class VSIDS {
+        ActivityHeap order;
+        double increment = 1.0;
+        double decayFactor;
+        double stableDecay;
+    public:
+        static constexpr double FocusedDecay = 0.85;
 
+        explicit VSIDS(std::size_t numVars, double decay = 0.95);
 
-    
+        Variable operator()(const std::vector<TruthValue> &model, std::size_t);
 
+        /**
+         * Bumps the activity of the given variables and decays (increases the bump increment)
+         * @param vars variables involved in the conflict
+         */
+        void onConflict(const std::vector<Variable> &vars);
+
+        /**
+         * Puts a variable back into the decision heap
+         * @param x variable that became unassigned
+         */
+        void onUnassign(Variable x);
 
+        /**
+         * Focused search decays faster (FocusedDecay) to concentrate on recent conflicts, stable search uses the decay
+         * factor given at construction
+         * @param stable whether the solver switches to stable search
+         */
+        void onModeSwitch(bool stable);
+
+        /**
+         * @return activity of the variable
+         */
+        double score(Variable x) const;
+    };
+
+    /**
+     * @brief Learning rate branching (LRB)
+     * @details
+     * Branching as a multi-armed bandit: while a variable is assigned, it collects a reward for every conflict it
+     * takes part in (seen in conflict analysis). When it gets unassigned, its learning rate
+     * participated conflicts / conflicts since assignment is folded into its score with an exponential moving
+     * average whose step size decreases from 0.4 to 0.06 over the run. Next decision variable = unassigned variable
+     * with maximum score in O(log n), the heap is cleaned lazily like in VSIDS. Requires the onAssign and onUnassign
+     * notifications.
+     */
+    class LRB {
+        ActivityHeap order;
+        std::vector<std::uint64_t> assignedAt;
+        std::vector<std::uint64_t> participated;
+        std::uint64_t conflicts = 0;
+        double stepSize = 0.4;
+    public:
+        static constexpr double MinStepSize = 0.06;
+        static constexpr double StepSizeDecrement = 1e-6;
+
+        explicit LRB(std::size_t numVars);
+
+        Variable operator()(const std::vector<TruthValue> &model, std::size_t);
+
+        /**
+         * Starts the learning interval of a variable
+         * @param x variable that was assigned
+         */
+        void onAssign(Variable x);
+
+        /**
+         * Ends the learning interval of a variable, updates its score and puts it back into the decision heap
+         * @param x variable that became unassigned
+         */
+        void onUnassign(Variable x);
+
+        /**
+         * Rewards the given variables
+         * @param vars variables involved in the conflict
+         */
+        void onConflict(const std::vector<Variable> &vars);
+
+        double score(Variable x) const;
+    };
+
+    /**
+     * @brief Per literal occurrence counters of a clause set
+     */
+    struct LiteralOccurrences {
+        std::vector<unsigned> count; ///< number of clauses containing the literal (indexed by literal id)
+        std::vector<unsigned> binary; ///< number of binary clauses containing the literal
+        std::vector<unsigned> ternary; ///< number of ternary clauses containing the literal
+        std::vector<double> jeroslowWang; ///< sum of 2^-|C| over all clauses C containing the literal
+
+        explicit LiteralOccurrences(std::size_t numVars);
+
+        void add(std::span<const Literal> clause);
+
+        void remove(std::span<const Literal> clause);
+    };
+
+    namespace detail {
+        /**
+         * Two-sided Jeroslow-Wang score J(x) + J(¬x)
+         */
+        struct JeroslowWangScore {
+            double operator()(const LiteralOccurrences &occ, Variable x) const;
+        };
+
+        /**
+         * MOMs score (f(x) + f(¬x)) * 2^k + f(x) * f(¬x) over binary clauses, ternary clauses break ties
+         */
+        struct MomsScore {
+            double operator()(const LiteralOccurrences &occ, Variable x) const;
+        };
+
+        /**
+         * DLIS score max(C(x), C(¬x))
+         */
+        struct DlisScore {
+            double operator()(const LiteralOccurrences &occ, Variable x) const;
+        };
+    }
+
+    /**
+     * @brief Static heuristic based on literal occurrence counts
+     * @details
+     * The counters are maintained by the solver through onClauseAdded / onClauseRemoved (clauses are removed when they
+     * are satisfied on the root level). Next decision variable = unassigned variable with maximum score in O(log n),
+     * the heap is cleaned lazily like in VSIDS. Scores are informed from the first decision on.
+     * @tparam Score scoring function of a variable given the occurrence counters
+     */
+    template<typename Score>
+    class OccurrenceHeuristic {
+        LiteralOccurrences occurrences;
+        ActivityHeap order;
+        Score scoring;
+
+        void update(std::span<const Literal> clause);
+    public:
+        explicit OccurrenceHeuristic(std::size_t numVars);
+
+        Variable operator()(const std::vector<TruthValue> &model, std::size_t);
+
+        void onClauseAdded(std::span<const Literal> clause);
+
+        void onClauseRemoved(std::span<const Literal> clause);
+
+        /**
+         * Puts a variable back into the decision heap
+         * @param x variable that became unassigned
+         */
+        void onUnassign(Variable x);
+
+        double score(Variable x) const;
+
+        const LiteralOccurrences &getOccurrences() const;
+    };
+
+    using JeroslowWang = OccurrenceHeuristic<detail::JeroslowWangScore>;
+    using Moms = OccurrenceHeuristic<detail::MomsScore>;
+    using Dlis = OccurrenceHeuristic<detail::DlisScore>;
+
+    extern template class OccurrenceHeuristic<detail::JeroslowWangScore>;
+    extern template class OccurrenceHeuristic<detail::MomsScore>;
+    extern template class OccurrenceHeuristic<detail::DlisScore>;
+
+    /**
+     * Concept modelling the polarity interface. A polarity heuristic is a type that can be called with the decision
+     * variable and returns the literal of that variable to assign first
+     */
+    template<typename P>
+    concept polarity = concepts::callable_r<P, Literal, Variable>;
+
+    /**
+     * @brief Polarity strategies of the PhaseSelector
+     * @details Negative / Positive: always the same sign. Saved: the last value the variable held (phase saving).
+     * Random: random sign. Target: value in the largest conflict free assignment seen so far, saved value otherwise
+     */
+    PENUM(PhaseMode, Negative, Positive, Saved, Random, Target)
+
+    /**
+     * @brief Rephasing strategies: overwrite the saved phases with the default sign (Original), the opposite of the
+     * default sign (Inverted), random signs (Random) or the best (largest conflict free) assignment seen (Best)
+     */
+    PENUM(Rephase, Original, Inverted, Random, Best)
+
+    /**
+     * @brief Polarity heuristic with phase saving and target phases
+     * @details Variables that never had a value (or no target value) get the default sign
+     */
+    class PhaseSelector {
+        PhaseMode mode;
+        bool positiveDefault;
+        std::vector<TruthValue> savedPhases;
+        std::vector<TruthValue> targetPhases;
+        std::size_t bestTrailSize = 0;
+    public:
+        /**
+         * Ctor
+         * @param numVars number of variables
+         * @param mode polarity strategy
+         * @param positiveDefault whether the default sign is positive
+         */
+        explicit PhaseSelector(std::size_t numVars, PhaseMode mode = PhaseMode::Saved, bool positiveDefault = false);
+
+        Literal operator()(Variable x) const;
+
+        /**
+         * Saves the phase of a literal that is about to be unassigned
+         * @param l assigned literal
+         */
+        void onUnassign(Literal l);
+
+        /**
+         * Stores the given assignment as target if it is larger than the best one seen so far
+         * @param assignment conflict free assignment (usually the trail up to the conflict level)
+         */
+        void updateTarget(std::span<const Literal> assignment);
+
+        /**
+         * Forgets the best assignment and clears the target phases so that the next conflict free assignment
+         * becomes the target
+         */
+        void resetTarget();
+
+        /**
+         * Overwrites the saved phases and resets the target phases (Rephase::Best copies them beforehand)
+         * @param kind rephasing strategy
+         */
+        void rephase(Rephase kind);
+
+        /**
+         * Overwrites the saved phases of the given literals and makes the assignment the new target
+         * @param assignment literals with the phases to import (e.g. the best assignment of a local search)
+         */
+        void importPhases(std::span<const Literal> assignment);
+
+        void setMode(PhaseMode phaseMode);
+
+        PhaseMode getMode() const;
+    };
 }
 
 #endif //HEURISTICS_HPP
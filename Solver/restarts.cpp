@@ -0,0 +1,107 @@
+/**
+* @date 16.10.26
+* @brief
+*/
+
+#include <algorithm>
+
+#include "restarts.hpp"
+
+namespace sat {
+
+    std::size_t luby(std::size_t i) {
+        std::size_t k = 1;
+        while ((1ULL << k) - 1 < i) ++k;
+        while (i != (1ULL << k) - 1) {
+            i = i - ((1ULL << (k - 1)) - 1);
+            k = 1;
+            while ((1ULL << k) - 1 < i) ++k;
+        }
+        return 1ULL << (k - 1);
+    }
+
+    LubyRestarts::LubyRestarts(std::size_t unit) : unit(unit) {}
+
+    void LubyRestarts::onConflict(unsigned, std::size_t) {
+        ++conflicts;
+    }
+
+    bool LubyRestarts::shouldRestart() const {
+        return conflicts >= unit * luby(restarts);
+    }
+
+    void LubyRestarts::onRestart() {
+        conflicts = 0;
+        ++restarts;
+    }
+
+    void LubyRestarts::reset() {
+        conflicts = 0;
+        restarts = 1;
+    }
+
+    GeometricRestarts::GeometricRestarts(double first, double factor) : first(first), factor(factor), interval(first) {}
+
+    void GeometricRestarts::onConflict(unsigned, std::size_t) {
+        ++conflicts;
+    }
+
+    bool GeometricRestarts::shouldRestart() const {
+        return static_cast<double>(conflicts) >= interval;
+    }
+
+    void GeometricRestarts::onRestart() {
+        conflicts = 0;
+        interval *= factor;
+    }
+
+    void GeometricRestarts::reset() {
+        conflicts = 0;
+        interval = first;
+    }
+
+    Ema::Ema(double alpha) : alpha(alpha) {}
+
+    void Ema::update(double x) {
+        ++count;
+        value += std::max(alpha, 1.0 / static_cast<double>(count)) * (x - value);
+    }
+
+    double Ema::get() const {
+        return value;
+    }
+
+    GlucoseRestarts::GlucoseRestarts(bool blocking)
+        : fastLbd(1.0 / 32), slowLbd(1.0 / 4096), trail(1.0 / 5000), blocking(blocking) {}
+
+    void GlucoseRestarts::onConflict(unsigned lbd, std::size_t trailSize) {
+        ++conflicts;
+        ++totalConflicts;
+        const auto size = static_cast<double>(trailSize);
+        if (blocking && totalConflicts > BlockingStart && conflicts >= MinConflicts &&
+            size > BlockingFactor * trail.get()) {
+            conflicts = 0;
+            ++blocked;
+        }
+
+        trail.update(size);
+        fastLbd.update(lbd);
+        slowLbd.update(lbd);
+    }
+
+    bool GlucoseRestarts::shouldRestart() const {
+        return conflicts >= MinConflicts && fastLbd.get() * Margin > slowLbd.get();
+    }
+
+    void GlucoseRestarts::onRestart() {
+        conflicts = 0;
+    }
+
+    void GlucoseRestarts::reset() {
+        conflicts = 0;
+    }
+
+    std::uint64_t GlucoseRestarts::numBlocked() const {
+        return blocked;
+    }
+}
@@ -0,0 +1,149 @@
+/**
+* @date 16.10.26
+* @file restarts.hpp
+* @brief Contains the restart policies of the solver
+*/
+
+#ifndef RESTARTS_HPP
+#define RESTARTS_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+
+#include "util/enum.hpp"
+
+namespace sat {
+    /**
+     * Concept modelling the restart policy interface. The solver reports every conflict together with the LBD of the
+     * conflict (learned) clause and the size of the trail at the time of the conflict. shouldRestart is queried after
+     * each conflict, onRestart is called when the solver actually restarted and reset when a new search starts.
+     */
+    template<typename R>
+    concept restart_policy = requires(R &r, unsigned lbd, std::size_t trailSize) {
+        r.onConflict(lbd, trailSize);
+        { r.shouldRestart() } -> std::convertible_to<bool>;
+        r.onRestart();
+        r.reset();
+    };
+
+    /**
+     * @brief Restart policies available in the solver
+     */
+    PENUM(RestartStrategy, Luby, Geometric, Glucose, None)
+
+    /**
+     * Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, ...
+     * @param i index starting at 1
+     * @return i-th element of the Luby sequence
+     */
+    std::size_t luby(std::size_t i);
+
+    /**
+     * @brief Static restarts after unit * luby(i) conflicts
+     */
+    class LubyRestarts {
+        std::size_t unit;
+        std::size_t restarts = 1;
+        std::size_t conflicts = 0;
+    public:
+        explicit LubyRestarts(std::size_t unit = 100);
+
+        void onConflict(unsigned lbd, std::size_t trailSize);
+
+        bool shouldRestart() const;
+
+        void onRestart();
+
+        void reset();
+    };
+
+    /**
+     * @brief Static restarts with geometrically growing intervals first, first * factor, first * factor^2, ...
+     */
+    class GeometricRestarts {
+        double first;
+        double factor;
+        double interval;
+        std::size_t conflicts = 0;
+    public:
+        explicit GeometricRestarts(double first = 100, double factor = 1.5);
+
+        void onConflict(unsigned lbd, std::size_t trailSize);
+
+        bool shouldRestart() const;
+
+        void onRestart();
+
+        void reset();
+    };
+
+    /**
+     * @brief Exponential moving average. Bias corrected at the beginning: the first n values are averaged with
+     * weight max(alpha, 1 / n)
+     */
+    class Ema {
+        double alpha;
+        double value = 0;
+        std::uint64_t count = 0;
+    public:
+        explicit Ema(double alpha);
+
+        void update(double x);
+
+        double get() const;
+    };
+
+    /**
+     * @brief Glucose style dynamic restarts
+     * @details
+     * Keeps a fast and a slow moving average of the LBDs of learned clauses. A restart is triggered if the recent
+     * clauses are significantly worse than the average, i.e. fast * Margin > slow, but at most every MinConflicts
+     * conflicts. Restarts are blocked (the interval starts again) if the trail at a conflict is much larger than
+     * usual (trailSize > BlockingFactor * average trail size), since the solver is then likely close to a model.
+     */
+    class GlucoseRestarts {
+        Ema fastLbd;
+        Ema slowLbd;
+        Ema trail;
+        std::size_t conflicts = 0;
+        std::uint64_t totalConflicts = 0;
+        std::uint64_t blocked = 0;
+        bool blocking;
+    public:
+        static constexpr double Margin = 0.8;
+        static constexpr std::size_t MinConflicts = 50;
+        static constexpr double BlockingFactor = 1.4;
+        static constexpr std::uint64_t BlockingStart = 10000; ///< no blocking during the first conflicts
+
+        explicit GlucoseRestarts(bool blocking = true);
+
+        void onConflict(unsigned lbd, std::size_t trailSize);
+
+        bool shouldRestart() const;
+
+        void onRestart();
+
+        void reset();
+
+        /**
+         * Number of blocked restarts
+         */
+        std::uint64_t numBlocked() const;
+    };
+
+    /**
+     * @brief Policy that never restarts
+     */
+    struct NoRestarts {
+        void onConflict(unsigned, std::size_t) {}
+
+        bool shouldRestart() const { return false; }
+
+        void onRestart() {}
+
+        void reset() {}
+    };
+}
+
+#endif //RESTARTS_HPP
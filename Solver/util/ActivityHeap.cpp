@@ -0,0 +1,122 @@
+/**
+* @date 16.10.26
+* @brief
+*/
+
+#include <cassert>
+#include <numeric>
+
+#include "ActivityHeap.hpp"
+
+namespace sat {
+
+    ActivityHeap::ActivityHeap(std::size_t numVars, double initialScore)
+        : scores(numVars, initialScore), heap(numVars), positions(numVars) {
+        // equal scores => ordering by id is already a valid heap
+        std::iota(heap.begin(), heap.end(), 0u);
+        std::iota(positions.begin(), positions.end(), std::size_t(0));
+    }
+
+    bool ActivityHeap::before(unsigned a, unsigned b) const {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+    }
+
+    void ActivityHeap::siftUp(std::size_t pos) {
+        const unsigned x = heap[pos];
+        while (pos > 0) {
+            const std::size_t parent = (pos - 1) / 2;
+            if (!before(x, heap[parent])) break;
+
+            heap[pos] = heap[parent];
+            positions[heap[pos]] = pos;
+            pos = parent;
+        }
+
+        heap[pos] = x;
+        positions[x] = pos;
+    }
+
+    void ActivityHeap::siftDown(std::size_t pos) {
+        const unsigned x = heap[pos];
+        while (true) {
+            std::size_t child = 2 * pos + 1;
+            if (child >= heap.size()) break;
+
+            if (child + 1 < heap.size() && before(heap[child + 1], heap[child])) {
+                ++child;
+            }
+
+            if (!before(heap[child], x)) break;
+
+            heap[pos] = heap[child];
+            positions[heap[pos]] = pos;
+            pos = child;
+        }
+
+        heap[pos] = x;
+        positions[x] = pos;
+    }
+
+    bool ActivityHeap::contains(Variable x) const {
+        return positions[x.get()] != NotInHeap;
+    }
+
+    void ActivityHeap::insert(Variable x) {
+        if (contains(x)) return;
+
+        heap.emplace_back(x.get());
+        positions[x.get()] = heap.size() - 1;
+        siftUp(heap.size() - 1);
+    }
+
+    Variable ActivityHeap::pop() {
+        assert(!heap.empty());
+        const unsigned x = heap.front();
+        positions[x] = NotInHeap;
+        const unsigned last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap.front() = last;
+            positions[last] = 0;
+            siftDown(0);
+        }
+
+        return x;
+    }
+
+    Variable ActivityHeap::top() const {
+        assert(!heap.empty());
+        return heap.front();
+    }
+
+    bool ActivityHeap::empty() const {
+        return heap.empty();
+    }
+
+    std::size_t ActivityHeap::size() const {
+        return heap.size();
+    }
+
+    double ActivityHeap::score(Variable x) const {
+        return scores[x.get()];
+    }
+
+    void ActivityHeap::setScore(Variable x, double score) {
+        const double old = scores[x.get()];
+        scores[x.get()] = score;
+        if (!contains(x)) return;
+
+        if (score > old) {
+            siftUp(positions[x.get()]);
+        } else {
+            siftDown(positions[x.get()]);
+        }
+    }
+
+    void ActivityHeap::scale(double factor) {
+        assert(factor > 0);
+        for (auto &s : scores) {
+            s *= factor;
+        }
+    }
+}
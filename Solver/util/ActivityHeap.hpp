@@ -0,0 +1,84 @@
+/**
+* @date 16.10.26
+* @file ActivityHeap.hpp
+* @brief Contains an indexed binary max-heap of variables ordered by a score
+*/
+
+#ifndef ACTIVITYHEAP_HPP
+#define ACTIVITYHEAP_HPP
+
+#include <vector>
+#include <cstddef>
+#include <limits>
+
+#include "../basic_structures.hpp"
+
+namespace sat {
+
+    /**
+     * @brief Binary max-heap over variable ids. The heap owns the scores of all variables (also of the ones that are
+     * currently not in the heap).
+     * @details @copybrief
+     * Insertion, removal and score updates are O(log n), membership tests and score lookups are O(1)
+     */
+    class ActivityHeap {
+        static constexpr std::size_t NotInHeap = std::numeric_limits<std::size_t>::max();
+        std::vector<double> scores;
+        std::vector<unsigned> heap;
+        std::vector<std::size_t> positions;
+
+        bool before(unsigned a, unsigned b) const;
+
+        void siftUp(std::size_t pos);
+
+        void siftDown(std::size_t pos);
+
+    public:
+        /**
+         * Ctor. All variables are inserted with the given score
+         * @param numVars number of variables
+         * @param initialScore score of all variables
+         */
+        explicit ActivityHeap(std::size_t numVars, double initialScore = 0);
+
+        /**
+         * Whether the variable is in the heap
+         */
+        bool contains(Variable x) const;
+
+        /**
+         * Inserts the variable (no op if it is already contained)
+         */
+        void insert(Variable x);
+
+        /**
+         * Removes and returns the variable with the highest score (ties are broken by smaller id)
+         * @note heap must not be empty
+         */
+        Variable pop();
+
+        /**
+         * Variable with the highest score
+         * @note heap must not be empty
+         */
+        Variable top() const;
+
+        bool empty() const;
+
+        std::size_t size() const;
+
+        double score(Variable x) const;
+
+        /**
+         * Sets the score of a variable and restores the heap order
+         */
+        void setScore(Variable x, double score);
+
+        /**
+         * Multiplies all scores by the given positive factor. This does not change the order
+         */
+        void scale(double factor);
+    };
+}
+
+#endif //ACTIVITYHEAP_HPP
@@ -78,6 +78,40 @@ TEST(clause, watcher_index) {
     EXPECT_EQ(c.getWatcherByRank(1), c[c.getIndex(1)]);
 }
 
+TEST(clause, inline_and_heap_storage) {
+    using namespace sat;
+    EXPECT_LE(sizeof(Clause), sizeof(std::vector<Literal>)) << "the inline buffer must not grow the clause";
+    for (std::size_t size = 1; size <= 2 * Clause::InlineCapacity; ++size) {
+        std::vector<Literal> lits;
+        for (unsigned i = 0; i < size; ++i) {
+            lits.emplace_back(2 * i + 1);
+        }
+
+        Clause c(lits);
+        Clause fromSpan{std::span<const Literal>(lits)};
+        EXPECT_THAT(std::vector(c.begin(), c.end()), testing::ElementsAreArray(lits));
+        EXPECT_THAT(std::vector(fromSpan.begin(), fromSpan.end()), testing::ElementsAreArray(lits));
+        EXPECT_TRUE(c.setWatcher(lits.back(), 1));
+        Clause copy = c;
+        EXPECT_TRUE(copy.sameLiterals(fromSpan));
+        EXPECT_EQ(copy.getWatcherByRank(1), lits.back());
+        Clause moved = std::move(c);
+        EXPECT_EQ(moved.size(), size);
+        EXPECT_EQ(moved.getWatcherByRank(1), lits.back());
+        EXPECT_THAT(std::vector(moved.begin(), moved.end()), testing::UnorderedElementsAreArray(lits));
+
+        // assignments between inline and heap storage
+        Clause other({pos(20), neg(21), pos(22), neg(23), pos(24), neg(25)});
+        other = moved;
+        EXPECT_TRUE(other.sameLiterals(fromSpan));
+        Clause unit({pos(20)});
+        unit = std::move(other);
+        EXPECT_TRUE(unit.sameLiterals(fromSpan));
+        other = unit;
+        EXPECT_TRUE(other.sameLiterals(unit));
+    }
+}
+
 #ifndef __RUN_ALL_TESTS__
 
 int main(int argc, char **argv) {
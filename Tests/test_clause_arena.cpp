@@ -0,0 +1,73 @@
+/**
+* @date 16.10.26
+* @brief
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <vector>
+
+#include "ClauseArena.hpp"
+
+TEST(clause_arena, allocate) {
+    using namespace sat;
+    ClauseArena arena;
+    const std::vector lits1{pos(0), neg(1), pos(2)};
+    const std::vector lits2{neg(3), neg(4)};
+    const auto c1 = arena.allocate(lits1);
+    const auto c2 = arena.allocate(lits2, true);
+    EXPECT_NE(c1, c2);
+    EXPECT_THAT(arena.literals(c1), testing::ElementsAreArray(lits1));
+    EXPECT_THAT(arena.literals(c2), testing::ElementsAreArray(lits2));
+    EXPECT_EQ(arena.size(c1), 3);
+    EXPECT_FALSE(arena.isLearnt(c1));
+    EXPECT_TRUE(arena.isLearnt(c2));
+    EXPECT_EQ(arena.capacity(), 2 * ClauseArena::HeaderSize + 5);
+    EXPECT_EQ(arena.garbage(), 0);
+}
+
+TEST(clause_arena, reorder_literals) {
+    using namespace sat;
+    ClauseArena arena;
+    const auto c1 = arena.allocate(std::vector{pos(0), neg(1), pos(2)});
+    const auto c2 = arena.allocate(std::vector{neg(3), neg(4)});
+    auto lits = arena.literals(c1);
+    std::swap(lits[1], lits[2]);
+    EXPECT_THAT(arena.literals(c1), testing::ElementsAre(pos(0), pos(2), neg(1)));
+    EXPECT_THAT(arena.literals(c2), testing::ElementsAre(neg(3), neg(4)));
+}
+
+TEST(clause_arena, relocate) {
+    using namespace sat;
+    ClauseArena arena;
+    const auto c1 = arena.allocate(std::vector{pos(0), neg(1), pos(2)});
+    const auto c2 = arena.allocate(std::vector{neg(3), neg(4)});
+    const auto c3 = arena.allocate(std::vector{pos(5), pos(6), pos(7), pos(8)}, true);
+    std::swap(arena.literals(c3)[0], arena.literals(c3)[3]);
+    arena.free(c2);
+    EXPECT_TRUE(arena.isDeleted(c2));
+    EXPECT_EQ(arena.garbage(), ClauseArena::HeaderSize + 2);
+
+    ClauseArena to;
+    const auto r3 = arena.relocate(c3, to);
+    const auto r1 = arena.relocate(c1, to);
+    EXPECT_EQ(arena.relocate(c2, to), NoClause);
+    EXPECT_EQ(arena.relocate(c3, to), r3) << "second relocation returns the forward reference";
+    EXPECT_EQ(arena.relocate(c1, to), r1);
+    EXPECT_EQ(to.capacity(), 2 * ClauseArena::HeaderSize + 7);
+    EXPECT_EQ(to.garbage(), 0);
+    EXPECT_THAT(to.literals(r1), testing::ElementsAre(pos(0), neg(1), pos(2)));
+    EXPECT_THAT(to.literals(r3), testing::ElementsAre(pos(8), pos(6), pos(7), pos(5)));
+    EXPECT_TRUE(to.isLearnt(r3));
+    EXPECT_FALSE(to.isDeleted(r3));
+}
+
+#ifndef __RUN_ALL_TESTS__
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    testing::InitGoogleMock(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+#endif
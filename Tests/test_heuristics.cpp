@@ -0,0 +1,278 @@
+/**
+* @date 16.10.26
+* @brief
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <vector>
+
+#include "heuristics.hpp"
+#include "printing.hpp"
+#include "util/ActivityHeap.hpp"
+#include "util/exception.hpp"
+
+TEST(activity_heap, order) {
+    using namespace sat;
+    ActivityHeap heap(6);
+    EXPECT_EQ(heap.size(), 6);
+    heap.setScore(4, 3);
+    heap.setScore(1, 5);
+    heap.setScore(5, 3);
+    heap.setScore(1, 0.5);
+    std::vector<unsigned> order;
+    while (!heap.empty()) {
+        order.emplace_back(heap.pop().get());
+    }
+
+    EXPECT_THAT(order, testing::ElementsAre(4, 5, 1, 0, 2, 3));
+    heap.insert(2);
+    heap.insert(4);
+    heap.insert(2);
+    EXPECT_EQ(heap.size(), 2);
+    EXPECT_FALSE(heap.contains(1));
+    EXPECT_EQ(heap.top(), 4);
+    heap.scale(0.5);
+    EXPECT_DOUBLE_EQ(heap.score(4), 1.5);
+}
+
+TEST(vsids, selection) {
+    using namespace sat;
+    static_assert(heuristic<VSIDS>);
+    VSIDS h(4);
+    std::vector<TruthValue> model(4, TruthValue::Undefined);
+    h.onConflict({2, 3});
+    h.onConflict({3});
+    EXPECT_GT(h.score(3), h.score(2));
+    EXPECT_EQ(h(model, 4), 3);
+    model[3] = TruthValue::True;
+    model[2] = TruthValue::False;
+    EXPECT_EQ(h(model, 2), 0) << "assigned variables must be skipped";
+    model[2] = TruthValue::Undefined;
+    h.onUnassign(2);
+    EXPECT_EQ(h(model, 2), 2);
+}
+
+TEST(vsids, mode_switch) {
+    using namespace sat;
+    constexpr double StableDecay = 0.95;
+    VSIDS h(6, StableDecay);
+    h.onConflict({0});
+    h.onConflict({1});
+    EXPECT_DOUBLE_EQ(h.score(1) / h.score(0), 1 / StableDecay);
+    // the increment of the next conflict is decayed after each conflict
+    h.onModeSwitch(false);
+    h.onConflict({2});
+    h.onConflict({3});
+    EXPECT_DOUBLE_EQ(h.score(3) / h.score(2), 1 / VSIDS::FocusedDecay) << "focused search bumps more aggressively";
+    h.onModeSwitch(true);
+    h.onConflict({4});
+    h.onConflict({5});
+    EXPECT_DOUBLE_EQ(h.score(5) / h.score(4), 1 / StableDecay);
+}
+
+TEST(lrb, learning_rate) {
+    using namespace sat;
+    static_assert(heuristic<LRB>);
+    LRB h(3);
+    std::vector<TruthValue> model(3, TruthValue::Undefined);
+    h.onAssign(0);
+    h.onAssign(1);
+    h.onConflict({0});
+    h.onConflict({0, 1});
+    h.onUnassign(0);
+    h.onUnassign(1);
+    EXPECT_NEAR(h.score(0), 0.4, 1e-5) << "variable took part in all conflicts";
+    EXPECT_NEAR(h.score(1), 0.2, 1e-5);
+    EXPECT_EQ(h(model, 3), 0);
+    EXPECT_EQ(h(model, 2), 1);
+    h.onAssign(2);
+    h.onUnassign(2);
+    EXPECT_DOUBLE_EQ(h.score(2), 0) << "no conflicts since assignment => no update";
+}
+
+TEST(occurrence, static_scores) {
+    using namespace sat;
+    static_assert(heuristic<JeroslowWang> && heuristic<Moms> && heuristic<Dlis>);
+    std::vector<Clause> clauses{
+        Clause({pos(1), pos(2)}), Clause({neg(1), pos(0)}),
+        Clause({pos(2), pos(0), pos(3)}), Clause({pos(2), neg(0), neg(3)}),
+        Clause({pos(2), pos(3), neg(0)}), Clause({pos(2), pos(1), pos(3)})};
+    JeroslowWang jw(4);
+    Moms moms(4);
+    Dlis dlis(4);
+    for (const auto &c : clauses) {
+        jw.onClauseAdded(c);
+        moms.onClauseAdded(c);
+        dlis.onClauseAdded(c);
+    }
+
+    EXPECT_EQ(dlis.getOccurrences().count[pos(2).get()], 5);
+    EXPECT_EQ(moms.getOccurrences().binary[neg(1).get()], 1);
+    EXPECT_DOUBLE_EQ(jw.getOccurrences().jeroslowWang[pos(2).get()], 0.25 + 4 * 0.125);
+    std::vector<TruthValue> model(4, TruthValue::Undefined);
+    EXPECT_EQ(jw(model, 4), 2);
+    EXPECT_EQ(moms(model, 4), 1) << "variable with most occurrences in binary clauses";
+    EXPECT_EQ(dlis(model, 4), 2);
+
+    // satisfied clauses no longer count
+    for (std::size_t i = 2; i < clauses.size(); ++i) {
+        dlis.onClauseRemoved(clauses[i]);
+    }
+
+    dlis.onUnassign(2);
+    EXPECT_EQ(dlis.getOccurrences().count[pos(2).get()], 1);
+    EXPECT_EQ(dlis(model, 4), 0) << "ties are broken by the smaller variable id";
+}
+
+struct CallbackCounter {
+    unsigned assigned = 0;
+    unsigned unassigned = 0;
+    unsigned conflicts = 0;
+    unsigned restarts = 0;
+};
+
+struct CountingHeuristic {
+    CallbackCounter *counter;
+
+    sat::Variable operator()(const std::vector<sat::TruthValue> &, std::size_t) const {
+        return 0;
+    }
+
+    void onAssign(sat::Variable) { ++counter->assigned; }
+    void onUnassign(sat::Variable) { ++counter->unassigned; }
+    void onConflict(const std::vector<sat::Variable> &) { ++counter->conflicts; }
+    void onRestart() { ++counter->restarts; }
+};
+
+TEST(heuristic_wrapper, incremental_callbacks) {
+    using namespace sat;
+    static_assert(incremental_heuristic<CountingHeuristic>);
+    static_assert(incremental_heuristic<Heuristic>);
+    static_assert(!incremental_heuristic<VSIDS>);
+    CallbackCounter counter;
+    Heuristic h(CountingHeuristic{&counter});
+    h.onAssign(1);
+    h.onAssign(2);
+    h.onUnassign(1);
+    h.onConflict({1, 2});
+    h.onRestart();
+    EXPECT_EQ(counter.assigned, 2);
+    EXPECT_EQ(counter.unassigned, 1);
+    EXPECT_EQ(counter.conflicts, 1);
+    EXPECT_EQ(counter.restarts, 1);
+
+    // callbacks not supported by the heuristic are ignored
+    Heuristic first(FirstVariable{});
+    first.onAssign(0);
+    first.onRestart();
+    EXPECT_THROW(Heuristic{}.onAssign(0), BadHeuristicCall);
+}
+
+template<typename H>
+concept has_on_assign = requires(H &h) { h.onAssign(sat::Variable(0)); };
+
+template<typename H>
+concept has_on_unassign = requires(H &h) { h.onUnassign(sat::Variable(0)); };
+
+TEST(heuristic_wrapper, movable_heuristic) {
+    using namespace sat;
+    static_assert(has_on_unassign<MovableHeuristic<VSIDS>> && !has_on_assign<MovableHeuristic<VSIDS>>);
+    static_assert(has_on_assign<MovableHeuristic<LRB>>);
+    MovableHeuristic<VSIDS> h(3);
+    std::vector<TruthValue> model(3, TruthValue::Undefined);
+    h.onConflict({2});
+    EXPECT_EQ(h(model, 3), 2);
+    h.onUnassign(2);
+    EXPECT_EQ(h(model, 3), 2);
+}
+
+TEST(polarity, fixed_sign) {
+    using namespace sat;
+    static_assert(polarity<PhaseSelector>);
+    PhaseSelector negative(5, PhaseMode::Negative);
+    PhaseSelector positive(5, PhaseMode::Positive);
+    negative.onUnassign(pos(2));
+    positive.onUnassign(neg(2));
+    EXPECT_EQ(negative(2), neg(2));
+    EXPECT_EQ(positive(2), pos(2));
+}
+
+TEST(polarity, saved_phase) {
+    using namespace sat;
+    PhaseSelector phases(5, PhaseMode::Saved, true);
+    EXPECT_EQ(phases(3), pos(3)) << "Variables without saved phase must get the default sign";
+    phases.onUnassign(neg(3));
+    EXPECT_EQ(phases(3), neg(3));
+    phases.onUnassign(pos(3));
+    EXPECT_EQ(phases(3), pos(3));
+}
+
+TEST(polarity, target_phase) {
+    using namespace sat;
+    PhaseSelector phases(5, PhaseMode::Target);
+    std::vector<Literal> best{pos(0), pos(1), neg(2)};
+    std::vector<Literal> smaller{neg(0), neg(1)};
+    phases.updateTarget(best);
+    phases.updateTarget(smaller);
+    EXPECT_EQ(phases(0), pos(0));
+    EXPECT_EQ(phases(1), pos(1));
+    EXPECT_EQ(phases(2), neg(2));
+    phases.onUnassign(pos(4));
+    EXPECT_EQ(phases(4), pos(4)) << "Variables without target phase must use the saved phase";
+    phases.resetTarget();
+    phases.updateTarget(smaller);
+    EXPECT_EQ(phases(0), neg(0));
+}
+
+TEST(polarity, rephase) {
+    using namespace sat;
+    PhaseSelector phases(3, PhaseMode::Saved);
+    phases.onUnassign(pos(0));
+    phases.rephase(Rephase::Original);
+    EXPECT_EQ(phases(0), neg(0));
+    phases.rephase(Rephase::Inverted);
+    EXPECT_EQ(phases(0), pos(0));
+    EXPECT_EQ(phases(2), pos(2));
+
+    std::vector<Literal> best{neg(0), pos(1)};
+    phases.updateTarget(best);
+    phases.rephase(Rephase::Best);
+    EXPECT_EQ(phases(0), neg(0));
+    EXPECT_EQ(phases(1), pos(1));
+    EXPECT_EQ(phases(2), pos(2)) << "variables outside the best assignment keep their saved phase";
+    std::vector<Literal> smaller{pos(0)};
+    phases.updateTarget(smaller);
+    phases.setMode(PhaseMode::Target);
+    EXPECT_EQ(phases(0), pos(0)) << "rephasing resets the target";
+}
+
+TEST(polarity, rephase_target_mode) {
+    using namespace sat;
+    PhaseSelector phases(3, PhaseMode::Target);
+    std::vector<Literal> best{pos(0), pos(1)};
+    phases.updateTarget(best);
+    phases.rephase(Rephase::Original);
+    EXPECT_EQ(phases(0), neg(0)) << "stale target phases must not override the rephased saved phases";
+    EXPECT_EQ(phases(1), neg(1));
+    phases.rephase(Rephase::Inverted);
+    EXPECT_EQ(phases(0), pos(0));
+    EXPECT_EQ(phases(2), pos(2));
+
+    std::vector<Literal> other{neg(0), neg(1)};
+    phases.updateTarget(other);
+    phases.rephase(Rephase::Best);
+    EXPECT_EQ(phases(0), neg(0)) << "best rephasing copies the target before clearing it";
+    EXPECT_EQ(phases(1), neg(1));
+    EXPECT_EQ(phases(2), pos(2));
+}
+
+#ifndef __RUN_ALL_TESTS__
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    testing::InitGoogleMock(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+#endif
@@ -0,0 +1,170 @@
+/**
+* @date 16.10.26
+* @brief
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <vector>
+#include <fstream>
+#include <chrono>
+
+#include "LocalSearch.hpp"
+#include "Solver.hpp"
+#include "inout.hpp"
+#include "testing_utils.hpp"
+#include "util/random.hpp"
+
+/**
+ * Random 3-SAT instance with a planted model (odd variables true, even variables false)
+ */
+static std::vector<sat::Clause> plantedInstance(unsigned numVariables, unsigned numClauses) {
+    using namespace sat;
+    auto &rng = RNG::get();
+    rng.setSeed(42);
+    auto planted = [](Variable x) { return x.get() % 2 ? pos(x) : neg(x); };
+    std::vector<Clause> clauses;
+    while (clauses.size() < numClauses) {
+        std::vector<Literal> lits;
+        bool satisfied = false;
+        for (unsigned i = 0; i < 3; ++i) {
+            const Variable x(rng.random_int(0u, numVariables - 1));
+            const Literal l = rng.random_int(0, 1) ? pos(x) : neg(x);
+            satisfied |= l == planted(x);
+            lits.emplace_back(l);
+        }
+
+        if (satisfied) {
+            clauses.emplace_back(std::move(lits));
+        }
+    }
+
+    return clauses;
+}
+
+class local_search : public testing::TestWithParam<sat::LocalSearchAlgorithm> {};
+
+TEST_P(local_search, planted_model) {
+    using namespace sat;
+    LocalSearch ls(100, GetParam());
+    for (const auto &c : plantedInstance(100, 400)) {
+        ls.addClause(c);
+    }
+
+    ASSERT_TRUE(ls.solve(1'000'000)) << GetParam();
+    EXPECT_TRUE(ls.verify());
+    EXPECT_GT(ls.getFlips(), 0);
+    const auto model = ls.getModel();
+    ASSERT_EQ(model.size(), 100);
+    for (unsigned x = 0; x < 100; ++x) {
+        EXPECT_EQ(var(model[x]), Variable(x));
+    }
+}
+
+TEST_P(local_search, unsatisfiable) {
+    using namespace sat;
+    LocalSearch ls(3, GetParam());
+    ls.addClause(Clause({pos(0), pos(1)}));
+    ls.addClause(Clause({pos(0), neg(1)}));
+    ls.addClause(Clause({neg(0), pos(1)}));
+    ls.addClause(Clause({neg(0), neg(1)}));
+    EXPECT_FALSE(ls.solve(500));
+    EXPECT_EQ(ls.getFlips(), 500);
+    EXPECT_FALSE(ls.verify());
+    EXPECT_FALSE(ls.solve(100));
+    EXPECT_EQ(ls.getFlips(), 600);
+}
+
+INSTANTIATE_TEST_SUITE_P(local_search, local_search,
+                         testing::Values(sat::LocalSearchAlgorithm::ProbSat, sat::LocalSearchAlgorithm::WalkSat));
+
+TEST(local_search, initial_phases) {
+    using namespace sat;
+    LocalSearch ls(3);
+    ls.addClause(Clause({pos(0), pos(1), pos(2)}));
+    ls.addClause(Clause({neg(0), pos(0)})); // tautology is ignored
+    const std::vector model{neg(0), pos(1), neg(2)};
+    ls.setInitialPhases(model);
+    ASSERT_TRUE(ls.solve(0));
+    EXPECT_EQ(ls.getFlips(), 0);
+    EXPECT_EQ(ls.getModel(), model);
+}
+
+TEST(local_search, solver_mode) {
+    using namespace sat;
+    Solver s(100);
+    s.setSolveMode(SolveMode::LocalSearch);
+    for (auto &c : plantedInstance(100, 400)) {
+        s.addClause(std::move(c));
+    }
+
+    ASSERT_TRUE(s.solve());
+    EXPECT_GT(s.getStatistics().flips, 0);
+    EXPECT_EQ(s.getStatistics().conflicts, 0) << "the model found by the local search is used directly";
+    for (const auto &c : plantedInstance(100, 400)) {
+        EXPECT_TRUE(std::ranges::any_of(c, [&s](Literal l) {
+            return s.val(var(l)) == (l.sign() > 0 ? TruthValue::True : TruthValue::False);
+        }));
+    }
+}
+
+TEST(local_search, solver_mode_fixed_polarity) {
+    using namespace sat;
+    Solver s(100);
+    s.setSolveMode(SolveMode::LocalSearch);
+    s.setSearchRegime(SearchRegime::Focused);
+    s.setPolarity(PhaseMode::Negative);
+    for (auto &c : plantedInstance(100, 400)) {
+        s.addClause(std::move(c));
+    }
+
+    ASSERT_TRUE(s.solve());
+    EXPECT_EQ(s.getStatistics().decisions, 0) << "a verified model is assigned without search";
+    for (const auto &c : plantedInstance(100, 400)) {
+        EXPECT_TRUE(std::ranges::any_of(c, [&s](Literal l) {
+            return s.val(var(l)) == (l.sign() > 0 ? TruthValue::True : TruthValue::False);
+        }));
+    }
+}
+
+TEST(local_search, solver_mode_unsat) {
+    using namespace sat;
+    Solver s(3);
+    s.setSolveMode(SolveMode::LocalSearch);
+    s.addClause(Clause({pos(0), pos(1)}));
+    s.addClause(Clause({pos(0), neg(1)}));
+    s.addClause(Clause({neg(0), pos(1), pos(2)}));
+    s.addClause(Clause({neg(0), neg(1)}));
+    s.addClause(Clause({neg(0), neg(2)}));
+    EXPECT_FALSE(s.solve()) << "CDCL decides the instance after the local search failed";
+}
+
+TEST(local_search, solver_mode_structured) {
+    using namespace sat;
+    using namespace std::chrono_literals;
+    std::ifstream ifs(test::TestData::BlocksWorld);
+    ASSERT_TRUE(ifs.is_open());
+    auto [clauses, numVariables] = inout::read_from_dimacs(ifs);
+    Solver s(numVariables);
+    s.setSolveMode(SolveMode::LocalSearch);
+    for (auto &c : clauses) {
+        s.addClause(Clause(std::move(c)));
+    }
+
+    s.setLimits({.time = 10s});
+    EXPECT_EQ(s.solveLimited(), SolveStatus::Sat);
+    const std::uint64_t tryFlips = LocalSearch::TryFactor * numVariables;
+    EXPECT_GT(s.getStatistics().flips, tryFlips) << "the local search must restart before it stagnates";
+    EXPECT_LT(s.getStatistics().flips, 4 * tryFlips) << "the local search must stop once it stagnates";
+}
+
+#ifndef __RUN_ALL_TESTS__
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    testing::InitGoogleMock(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+#endif
@@ -0,0 +1,122 @@
+/**
+* @date 16.10.26
+* @brief
+*/
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <vector>
+
+#include "restarts.hpp"
+#include "Solver.hpp"
+
+template<sat::restart_policy R>
+static std::vector<std::size_t> restartIntervals(R &policy, std::size_t numRestarts, unsigned lbd = 5) {
+    std::vector<std::size_t> intervals;
+    std::size_t conflicts = 0;
+    while (intervals.size() < numRestarts) {
+        policy.onConflict(lbd, 10);
+        ++conflicts;
+        if (policy.shouldRestart()) {
+            intervals.emplace_back(conflicts);
+            conflicts = 0;
+            policy.onRestart();
+        }
+    }
+
+    return intervals;
+}
+
+TEST(restarts, luby_sequence) {
+    using namespace sat;
+    std::vector<std::size_t> seq;
+    for (std::size_t i = 1; i <= 15; ++i) {
+        seq.emplace_back(luby(i));
+    }
+
+    EXPECT_THAT(seq, testing::ElementsAre(1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2, 4, 8));
+    LubyRestarts policy(10);
+    EXPECT_THAT(restartIntervals(policy, 7), testing::ElementsAre(10, 10, 20, 10, 10, 20, 40));
+    policy.reset();
+    EXPECT_THAT(restartIntervals(policy, 2), testing::ElementsAre(10, 10));
+}
+
+TEST(restarts, geometric) {
+    using namespace sat;
+    GeometricRestarts policy(10, 2);
+    EXPECT_THAT(restartIntervals(policy, 4), testing::ElementsAre(10, 20, 40, 80));
+}
+
+TEST(restarts, glucose) {
+    using namespace sat;
+    GlucoseRestarts policy(false);
+    // constant LBD: the fast average never exceeds the slow one by the margin
+    for (unsigned i = 0; i < 1000; ++i) {
+        policy.onConflict(5, 10);
+        EXPECT_FALSE(policy.shouldRestart());
+    }
+
+    // LBDs of recent clauses degrade => restart as soon as the minimal interval has passed
+    for (unsigned i = 0; i < 20; ++i) {
+        policy.onConflict(20, 10);
+    }
+
+    EXPECT_TRUE(policy.shouldRestart());
+    policy.onRestart();
+    EXPECT_FALSE(policy.shouldRestart()) << "at least MinConflicts conflicts between restarts";
+}
+
+TEST(restarts, glucose_blocking) {
+    using namespace sat;
+    GlucoseRestarts policy;
+    for (std::uint64_t i = 0; i < GlucoseRestarts::BlockingStart; ++i) {
+        policy.onConflict(5, 10);
+    }
+
+    for (unsigned i = 0; i < GlucoseRestarts::MinConflicts; ++i) {
+        policy.onConflict(20, 10);
+    }
+
+    ASSERT_TRUE(policy.shouldRestart());
+    policy.onConflict(20, 100);
+    EXPECT_EQ(policy.numBlocked(), 1);
+    EXPECT_FALSE(policy.shouldRestart()) << "large trail blocks the restart";
+}
+
+class restart_policy : public testing::TestWithParam<sat::RestartStrategy> {};
+
+TEST_P(restart_policy, solve) {
+    using namespace sat;
+    for (auto mode : {SolveMode::Dpll, SolveMode::Cdcl}) {
+        Solver s(20);
+        s.setSolveMode(mode);
+        s.setRestartPolicy(GetParam());
+        for (unsigned p = 0; p <= 4; ++p) {
+            s.addClause(Clause({pos(4 * p), pos(4 * p + 1), pos(4 * p + 2), pos(4 * p + 3)}));
+        }
+
+        for (unsigned h = 0; h < 4; ++h) {
+            for (unsigned p = 0; p <= 4; ++p) {
+                for (unsigned q = p + 1; q <= 4; ++q) {
+                    s.addClause(Clause({neg(4 * p + h), neg(4 * q + h)}));
+                }
+            }
+        }
+
+        EXPECT_FALSE(s.solve()) << mode;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(restarts, restart_policy,
+                         testing::Values(sat::RestartStrategy::Luby, sat::RestartStrategy::Geometric,
+                                         sat::RestartStrategy::Glucose, sat::RestartStrategy::None));
+
+#ifndef __RUN_ALL_TESTS__
+
+int main(int argc, char **argv) {
+    testing::InitGoogleTest(&argc, argv);
+    testing::InitGoogleMock(&argc, argv);
+    return RUN_ALL_TESTS();
+}
+
+#endif
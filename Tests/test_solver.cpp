@@ -7,10 +7,12 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 #include <algorithm>
+#include <set>
 
 #include "printing.hpp"
 #include "Solver.hpp"
 #include "testing_utils.hpp"
+#include "util/exception.hpp"
 
 TEST(solver, initial_assignment) {
     using namespace sat;
@@ -104,6 +106,36 @@ TEST(solver, unit_propagation_complex) {
     EXPECT_TRUE(s.unitPropagate()) << "unit propagation failed";
 }
 
+TEST(solver, backtrack) {
+    using namespace sat;
+    auto clauses = {Clause({neg(1), pos(0), neg(2)}), Clause({neg(1), pos(2)}), Clause({neg(0), neg(3)})};
+    Solver s(4);
+    for (const auto &clause : clauses) {
+        ASSERT_TRUE(s.addClause(clause));
+    }
+
+    ASSERT_TRUE(s.decide(pos(1)));
+    ASSERT_TRUE(s.unitPropagate());
+    EXPECT_EQ(s.decisionLevel(), 1);
+    EXPECT_TRUE(s.satisfied(pos(2)));
+    EXPECT_TRUE(s.satisfied(pos(0)));
+    EXPECT_TRUE(s.satisfied(neg(3)));
+    s.backtrack(0);
+    EXPECT_EQ(s.decisionLevel(), 0);
+    for (unsigned varId = 0; varId < 4; ++varId) {
+        EXPECT_EQ(s.val(varId), TruthValue::Undefined);
+    }
+
+    ASSERT_TRUE(s.decide(neg(1)));
+    ASSERT_TRUE(s.decide(pos(3)));
+    ASSERT_TRUE(s.unitPropagate());
+    EXPECT_TRUE(s.satisfied(neg(0)));
+    s.backtrack(1);
+    EXPECT_TRUE(s.satisfied(neg(1)));
+    EXPECT_EQ(s.val(0), TruthValue::Undefined);
+    EXPECT_EQ(s.val(3), TruthValue::Undefined);
+}
+
 
 TEST(solver, rebase) {
     using namespace sat;
@@ -122,6 +154,358 @@ TEST(solver, rebase) {
         << "Clause " << Clause({neg(1), pos(2)}) << " was not found";
 }
 
+TEST(solver, rebase_duplicate_binaries) {
+    using namespace sat;
+    Solver s(4);
+    s.setSolveMode(SolveMode::Cdcl);
+    s.setHeuristic(BranchingHeuristic::FirstVariable);
+    s.setPolarity(PhaseMode::Positive);
+    ASSERT_TRUE(s.addClause(Clause({neg(0), neg(1), pos(2)})));
+    ASSERT_TRUE(s.addClause(Clause({neg(0), neg(1), neg(2)})));
+    // deciding x0 and x1 leads to a conflict => learns the binary (-x0 -x1)
+    ASSERT_TRUE(s.solve());
+    EXPECT_EQ(s.getStatistics().conflicts, 1);
+
+    const Clause binary({neg(0), neg(1)});
+    ASSERT_TRUE(s.addClause(binary));
+    ASSERT_TRUE(s.addClause(Clause({neg(0), neg(1), pos(3)})));
+    ASSERT_TRUE(s.addClause(Clause({neg(3)})));
+    const auto rebased = s.rebase();
+    EXPECT_EQ(std::ranges::count_if(rebased, [&binary](const auto &c) { return c.sameLiterals(binary); }), 1)
+        << "Clause " << binary << " must be contained exactly once";
+}
+
+TEST(solver, cdcl_sat) {
+    using namespace sat;
+    auto clauses = {Clause({neg(1), pos(0), neg(2)}), Clause({neg(1), pos(2)}), Clause({neg(0), neg(2)}),
+                    Clause({pos(1), pos(3)}), Clause({neg(3), pos(2), pos(0)})};
+    Solver s(4);
+    for (const auto &clause : clauses) {
+        ASSERT_TRUE(s.addClause(clause));
+    }
+
+    ASSERT_TRUE(s.solveCdcl());
+    for (const auto &clause : clauses) {
+        EXPECT_TRUE(std::ranges::any_of(clause, [&s](Literal l) { return s.satisfied(l); }))
+            << "Clause " << clause << " is not satisfied";
+    }
+}
+
+/**
+ * Pigeon hole problem (unsatisfiable): n + 1 pigeons, n holes. Variable n * p + h: pigeon p sits in hole h
+ */
+static void addPigeonHole(sat::Solver &s, unsigned n) {
+    using namespace sat;
+    for (unsigned p = 0; p <= n; ++p) {
+        std::vector<Literal> lits;
+        for (unsigned h = 0; h < n; ++h) {
+            lits.emplace_back(pos(n * p + h));
+        }
+
+        ASSERT_TRUE(s.addClause(Clause(std::move(lits))));
+    }
+
+    for (unsigned h = 0; h < n; ++h) {
+        for (unsigned p = 0; p <= n; ++p) {
+            for (unsigned q = p + 1; q <= n; ++q) {
+                ASSERT_TRUE(s.addClause(Clause({neg(n * p + h), neg(n * q + h)})));
+            }
+        }
+    }
+}
+
+TEST(solver, cdcl_unsat) {
+    using namespace sat;
+    Solver s(6);
+    addPigeonHole(s, 2);
+    EXPECT_FALSE(s.solveCdcl());
+}
+
+TEST(solver, binary_clauses) {
+    using namespace sat;
+    // implication chain x0 -> x1 -> ... -> x9 and x9 -> ¬x0
+    Solver s(10);
+    for (unsigned x = 0; x < 9; ++x) {
+        ASSERT_TRUE(s.addClause(Clause({neg(x), pos(x + 1)})));
+    }
+
+    ASSERT_TRUE(s.addClause(Clause({neg(9), neg(0)})));
+    ASSERT_TRUE(s.decide(pos(0)));
+    EXPECT_FALSE(s.unitPropagate());
+    s.backtrack(0);
+    ASSERT_TRUE(s.decide(pos(5)));
+    ASSERT_TRUE(s.unitPropagate());
+    for (unsigned x = 5; x < 10; ++x) {
+        EXPECT_EQ(s.val(x), TruthValue::True);
+    }
+
+    EXPECT_EQ(s.val(0), TruthValue::False);
+    s.backtrack(0);
+    const auto rebased = s.rebase();
+    EXPECT_EQ(rebased.size(), 10);
+    EXPECT_TRUE(test::findClause(Clause({neg(9), neg(0)}), rebased));
+
+    // conflict analysis learns the unit ¬x0 from binary reasons only
+    EXPECT_TRUE(s.solveCdcl());
+    EXPECT_EQ(s.val(0), TruthValue::False);
+    const std::vector assumption{pos(3)};
+    EXPECT_TRUE(s.solve(assumption));
+    EXPECT_EQ(s.val(9), TruthValue::True);
+}
+
+TEST(solver, lookahead_failed_literals) {
+    using namespace sat;
+    Solver s(3);
+    s.setSolveMode(SolveMode::Lookahead);
+    s.addClause(Clause({neg(0), pos(1)}));
+    s.addClause(Clause({neg(0), neg(1)}));
+    s.addClause(Clause({pos(0), pos(2)}));
+    ASSERT_TRUE(s.solve());
+    EXPECT_TRUE(s.falsified(pos(0)));
+    EXPECT_TRUE(s.satisfied(pos(2)));
+    EXPECT_EQ(s.getStatistics().decisions, 1) << "only the unconstrained variable 1 is decided";
+
+    Solver unsat(2);
+    unsat.setSolveMode(SolveMode::Lookahead);
+    unsat.addClause(Clause({pos(0), pos(1)}));
+    unsat.addClause(Clause({pos(0), neg(1)}));
+    unsat.addClause(Clause({neg(0), pos(1)}));
+    unsat.addClause(Clause({neg(0), neg(1)}));
+    EXPECT_FALSE(unsat.solve());
+    EXPECT_EQ(unsat.getStatistics().decisions, 0);
+}
+
+TEST(solver, lookahead_pigeon_hole) {
+    using namespace sat;
+    Solver s(30);
+    s.setSolveMode(SolveMode::Lookahead);
+    addPigeonHole(s, 5);
+    EXPECT_FALSE(s.solve());
+}
+
+/**
+ * Selects the smallest open variable using its own index of open variables (no scan of the model)
+ */
+struct OpenSetHeuristic {
+    std::set<unsigned> open;
+
+    explicit OpenSetHeuristic(unsigned numVariables) {
+        for (unsigned x = 0; x < numVariables; ++x) {
+            open.emplace(x);
+        }
+    }
+
+    sat::Variable operator()(const std::vector<sat::TruthValue> &, std::size_t) const {
+        return *open.begin();
+    }
+
+    void onAssign(sat::Variable x) { open.erase(x.get()); }
+    void onUnassign(sat::Variable x) { open.emplace(x.get()); }
+};
+
+TEST(solver, custom_incremental_heuristic) {
+    using namespace sat;
+    for (auto mode : {SolveMode::Dpll, SolveMode::Cdcl}) {
+        Solver s(12);
+        s.setSolveMode(mode);
+        s.setHeuristic(Heuristic(OpenSetHeuristic(12)));
+        addPigeonHole(s, 3);
+        EXPECT_FALSE(s.solve()) << mode;
+
+        Solver sat(4);
+        sat.setSolveMode(mode);
+        sat.setHeuristic(Heuristic(OpenSetHeuristic(4)));
+        sat.addClause(Clause({pos(0), pos(1)}));
+        sat.addClause(Clause({neg(0), pos(3)}));
+        EXPECT_TRUE(sat.solve()) << mode;
+    }
+
+    Solver s(1);
+    EXPECT_THROW(s.setHeuristic(Heuristic{}), BadHeuristicCall);
+}
+
+TEST(solver, partial_restarts) {
+    using namespace sat;
+    Solver s(42);
+    s.setSolveMode(SolveMode::Cdcl);
+    s.setRestartPolicy(RestartStrategy::Geometric);
+    addPigeonHole(s, 6);
+    EXPECT_FALSE(s.solve());
+    const auto &stats = s.getStatistics();
+    EXPECT_GT(stats.restarts, 0);
+    EXPECT_GT(stats.partialRestarts, 0) << "VSIDS keeps decisions that would be repeated";
+    EXPECT_LE(stats.partialRestarts, stats.restarts);
+    EXPECT_GE(stats.reusedAssignments, stats.partialRestarts);
+
+    // without scores the heuristic gives no hint which decisions would be repeated
+    Solver first(42);
+    first.setSolveMode(SolveMode::Cdcl);
+    first.setHeuristic(BranchingHeuristic::FirstVariable);
+    first.setRestartPolicy(RestartStrategy::Geometric);
+    addPigeonHole(first, 6);
+    EXPECT_FALSE(first.solve());
+    EXPECT_GT(first.getStatistics().restarts, 0);
+    EXPECT_EQ(first.getStatistics().partialRestarts, 0);
+
+    // kept assumption levels are not counted as saved work
+    Solver assumed(43);
+    assumed.setSolveMode(SolveMode::Cdcl);
+    assumed.setHeuristic(BranchingHeuristic::FirstVariable);
+    assumed.setRestartPolicy(RestartStrategy::Geometric);
+    addPigeonHole(assumed, 6);
+    const std::vector assumption{pos(42)};
+    EXPECT_FALSE(assumed.solve(assumption));
+    EXPECT_GT(assumed.getStatistics().restarts, 0);
+    EXPECT_EQ(assumed.getStatistics().partialRestarts, 0);
+    EXPECT_EQ(assumed.getStatistics().reusedAssignments, 0);
+}
+
+class branching : public testing::TestWithParam<sat::BranchingHeuristic> {};
+
+TEST_P(branching, cdcl_pigeon_hole) {
+    using namespace sat;
+    Solver s(20);
+    s.setHeuristic(GetParam());
+    s.setSolveMode(SolveMode::Cdcl);
+    addPigeonHole(s, 4);
+    EXPECT_FALSE(s.solve());
+}
+
+INSTANTIATE_TEST_SUITE_P(solver, branching,
+                         testing::Values(sat::BranchingHeuristic::Vsids, sat::BranchingHeuristic::Lrb,
+                                         sat::BranchingHeuristic::WeightedDegree,
+                                         sat::BranchingHeuristic::FirstVariable,
+                                         sat::BranchingHeuristic::JeroslowWang, sat::BranchingHeuristic::Moms,
+                                         sat::BranchingHeuristic::Dlis));
+
+class regime : public testing::TestWithParam<sat::SearchRegime> {};
+
+TEST_P(regime, pigeon_hole) {
+    using namespace sat;
+    Solver s(56);
+    s.setSolveMode(SolveMode::Cdcl);
+    s.setSearchRegime(GetParam());
+    addPigeonHole(s, 7);
+    EXPECT_FALSE(s.solve());
+
+    // one pigeon less
+    Solver sat(42);
+    sat.setSolveMode(SolveMode::Cdcl);
+    sat.setSearchRegime(GetParam());
+    for (unsigned p = 0; p < 6; ++p) {
+        std::vector<Literal> lits;
+        for (unsigned h = 0; h < 6; ++h) {
+            lits.emplace_back(pos(6 * p + h));
+        }
+
+        sat.addClause(Clause(std::move(lits)));
+        for (unsigned q = p + 1; q < 6; ++q) {
+            for (unsigned h = 0; h < 6; ++h) {
+                sat.addClause(Clause({neg(6 * p + h), neg(6 * q + h)}));
+            }
+        }
+    }
+
+    EXPECT_TRUE(sat.solve());
+}
+
+INSTANTIATE_TEST_SUITE_P(solver, regime, testing::Values(sat::SearchRegime::Focused, sat::SearchRegime::Stable,
+                                                         sat::SearchRegime::Alternating));
+
+/**
+ * VSIDS that records the mode switches of the solver
+ */
+struct ModeRecordingVSIDS : sat::VSIDS {
+    std::shared_ptr<std::vector<bool>> switches = std::make_shared<std::vector<bool>>();
+
+    using sat::VSIDS::VSIDS;
+
+    void onModeSwitch(bool stable) {
+        switches->push_back(stable);
+        VSIDS::onModeSwitch(stable);
+    }
+};
+
+TEST(solver, focused_regime_decay) {
+    using namespace sat;
+    // Focused is the default regime
+    Solver s(30);
+    s.setSolveMode(SolveMode::Cdcl);
+    ModeRecordingVSIDS vsids(30);
+    const auto switches = vsids.switches;
+    s.setHeuristic(Heuristic(std::move(vsids)));
+    addPigeonHole(s, 5);
+    EXPECT_FALSE(s.solve());
+    EXPECT_THAT(*switches, testing::ElementsAre(false)) << "focused search must use the focused decay";
+}
+
+class incremental : public testing::TestWithParam<sat::SolveMode> {};
+
+TEST_P(incremental, assumptions_and_added_clauses) {
+    using namespace sat;
+    Solver s(4);
+    s.setSolveMode(GetParam());
+    ASSERT_TRUE(s.addClause(Clause({neg(0), pos(1)})));
+    ASSERT_TRUE(s.addClause(Clause({neg(1), pos(2)})));
+    ASSERT_TRUE(s.addClause(Clause({neg(2), neg(0), pos(3)})));
+
+    std::vector<Literal> assumptions{pos(0), neg(3)};
+    EXPECT_FALSE(s.solve(assumptions));
+    ASSERT_TRUE(s.solve());
+
+    assumptions = {pos(0)};
+    ASSERT_TRUE(s.solve(assumptions));
+    EXPECT_TRUE(s.satisfied(pos(3)));
+
+    // the formula itself is not unsatisfiable after a failed call
+    ASSERT_TRUE(s.addClause(Clause({neg(3), neg(1)})));
+    EXPECT_FALSE(s.solve(assumptions));
+    assumptions = {neg(0)};
+    ASSERT_TRUE(s.solve(assumptions));
+    EXPECT_TRUE(s.satisfied(neg(0)));
+
+    // clause might already be falsified by a learned unit
+    s.addClause(Clause({pos(0)}));
+    EXPECT_FALSE(s.solve());
+}
+
+TEST_P(incremental, duplicate_assumptions) {
+    using namespace sat;
+    Solver s(3);
+    s.setSolveMode(GetParam());
+    s.setRestartPolicy(RestartStrategy::Glucose);
+    ASSERT_TRUE(s.addClause(Clause({neg(0), neg(1), pos(2)})));
+    ASSERT_TRUE(s.addClause(Clause({neg(0), neg(1), neg(2)})));
+    // every repeated assumption opens an empty level => more decision levels than variables
+    const std::vector assumptions{pos(0), pos(0), pos(0), pos(0), pos(0), pos(1)};
+    EXPECT_FALSE(s.solve(assumptions));
+    EXPECT_TRUE(s.solve());
+}
+
+TEST_P(incremental, budgeted_resume) {
+    using namespace sat;
+    Solver s(30);
+    s.setSolveMode(GetParam());
+    addPigeonHole(s, 5);
+    SolveLimits limits;
+    limits.conflicts = 20;
+    s.setLimits(limits);
+    unsigned calls = 0;
+    SolveStatus status;
+    do {
+        status = s.solveLimited();
+        ++calls;
+    } while (status == SolveStatus::Unknown && calls < 100000);
+
+    EXPECT_EQ(status, SolveStatus::Unsat);
+    EXPECT_GT(calls, 1);
+    EXPECT_GE(s.getStatistics().conflicts, 20);
+}
+
+INSTANTIATE_TEST_SUITE_P(solver, incremental,
+                         testing::Values(sat::SolveMode::Dpll, sat::SolveMode::FirstVariable, sat::SolveMode::Cdcl,
+                                         sat::SolveMode::Lookahead));
+
 #ifndef __RUN_ALL_TESTS__
 
 int main(int argc, char **argv) {
@@ -87,6 +87,61 @@ TEST(unit_propagation, problem4) {
     testEquality(gt, solver.rebase());
 }
 
+TEST(unit_propagation, incremental) {
+    using namespace sat;
+    Solver solver(6);
+    solver.addClause(Clause({neg(0), pos(1)}));
+    solver.addClause(Clause({neg(1), pos(2)}));
+    solver.addClause(Clause({neg(3), pos(4), pos(5)}));
+    const auto propagations = [&solver] { return solver.getStatistics().propagations; };
+    ASSERT_TRUE(solver.unitPropagate());
+    EXPECT_EQ(propagations(), 0);
+    ASSERT_TRUE(solver.decide(pos(0)));
+    ASSERT_TRUE(solver.unitPropagate());
+    EXPECT_EQ(propagations(), 3);
+    EXPECT_EQ(solver.val(2), TruthValue::True);
+    ASSERT_TRUE(solver.unitPropagate());
+    EXPECT_EQ(propagations(), 3) << "already propagated literals must not be visited again";
+    ASSERT_TRUE(solver.decide(pos(3)));
+    ASSERT_TRUE(solver.decide(neg(4)));
+    ASSERT_TRUE(solver.unitPropagate());
+    EXPECT_EQ(propagations(), 6);
+    EXPECT_EQ(solver.val(5), TruthValue::True);
+    solver.backtrack(1);
+    EXPECT_EQ(solver.val(5), TruthValue::Undefined);
+    ASSERT_TRUE(solver.decide(neg(5)));
+    ASSERT_TRUE(solver.unitPropagate());
+    EXPECT_EQ(propagations(), 7);
+}
+
+TEST(unit_propagation, long_clause) {
+    using namespace sat;
+    constexpr unsigned N = 21;
+    for (unsigned last = 0; last < N; ++last) {
+        Solver solver(N);
+        std::vector<Literal> lits;
+        for (unsigned x = 0; x < N; ++x) {
+            lits.emplace_back(pos(x));
+        }
+
+        solver.addClause(Clause(std::move(lits)));
+        // falsifies the literals in a scattered order, the replacement watcher is searched in all positions
+        for (unsigned i = 1; i < N; ++i) {
+            const unsigned x = (last + i * 8) % N;
+            ASSERT_TRUE(solver.decide(neg(x)));
+            ASSERT_TRUE(solver.unitPropagate());
+            EXPECT_EQ(solver.val(last), i + 1 < N ? TruthValue::Undefined : TruthValue::True);
+        }
+
+        solver.backtrack(0);
+        for (unsigned x = 0; x < N; ++x) {
+            ASSERT_TRUE(solver.decide(neg(x)));
+        }
+
+        EXPECT_FALSE(solver.unitPropagate());
+    }
+}
+
 #ifndef __RUN_ALL_TESTS__
 
 int main(int argc, char **argv) {
@@ -27,6 +27,8 @@ namespace test {
         static constexpr auto UnitPropagationSolution2 = __TEST_DATA_DIR__ "res2.cnf";
         static constexpr auto UnitPropagationSolution3 = __TEST_DATA_DIR__ "res3.cnf";
         static constexpr auto UnitPropagationSolution4 = __TEST_DATA_DIR__ "res4.cnf";
+        // instance of the evaluation set
+        static constexpr auto BlocksWorld = __TEST_DATA_DIR__ "../../eval/sat/medium/bw_large.b.cnf";
     };
 
     template<typename T>
@@ -0,0 +1,96 @@
+/**
+ * Unit propagation microbenchmark.
+ *
+ * Usage:
+ *   ./bench_propagation path/to/file.cnf [--rounds <n>] [--seed <n>]
+ *
+ * Options:
+ *   --rounds  number of random descents (default 2000)
+ *   --seed  random seed of the decision sequences (default 0)
+ *
+ * Each round decides random open variables with random polarity and propagates until all variables are assigned or a
+ * conflict occurs, then backtracks to the root level. The decision sequences only depend on the seed, so the amount of
+ * work is the same for all versions of the propagation code as long as it assigns the same literals
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "Solver/Solver.hpp"
+#include "Solver/inout.hpp"
+#include "Solver/util/cli.hpp"
+#include "Solver/util/random.hpp"
+
+int main(int argc, char **argv) {
+    using namespace sat;
+    unsigned rounds = 2000;
+    unsigned seed = 0;
+    const std::string cnfFile = cli::parse(argc, argv, cli::ValueArg("--rounds", rounds),
+                                           cli::ValueArg("--seed", seed));
+    std::ifstream ifs(cnfFile);
+    if (!ifs.is_open()) {
+        std::cout << "c Could not open file " << cnfFile << "\n";
+        return 1;
+    }
+
+    auto [clauses, numVariables] = inout::read_from_dimacs(ifs);
+    if (numVariables == 0) {
+        std::cout << "c Instance has no variables\n";
+        return 1;
+    }
+
+    Solver solver(numVariables);
+    for (auto &cl : clauses) {
+        solver.addClause(Clause(std::move(cl)));
+    }
+
+    if (!solver.unitPropagate()) {
+        std::cout << "c Conflict at the root level\n";
+        return 0;
+    }
+
+    const auto n = static_cast<unsigned>(numVariables);
+    auto &rng = RNG::get();
+    rng.setSeed(seed);
+    std::uint64_t conflicts = 0;
+    std::uint64_t decisions = 0;
+    const std::uint64_t start = solver.getStatistics().propagations;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < rounds; ++r) {
+        while (true) {
+            // random open variable: linear probing from a random start
+            unsigned x = rng.random_int(0u, n - 1);
+            unsigned probes = 0;
+            while (solver.val(x) != TruthValue::Undefined && probes < n) {
+                x = (x + 1) % n;
+                ++probes;
+            }
+
+            if (probes == n) {
+                break;
+            }
+
+            ++decisions;
+            solver.decide(rng.random_int(0, 1) ? pos(x) : neg(x));
+            if (!solver.unitPropagate()) {
+                ++conflicts;
+                break;
+            }
+        }
+
+        solver.backtrack(0);
+    }
+
+    const auto t1 = std::chrono::steady_clock::now();
+    const auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+    const std::uint64_t propagations = solver.getStatistics().propagations - start;
+    std::cout << "c File: " << cnfFile << "\n";
+    std::cout << "c Rounds: " << rounds << ", decisions: " << decisions << ", conflicts: " << conflicts << "\n";
+    std::cout << "c Propagations: " << propagations << " in " << us / 1000 << " ms ("
+              << propagations * 1000000 / static_cast<std::uint64_t>(std::max<long long>(us, 1)) << "/s)\n";
+    return 0;
+}
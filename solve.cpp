@@ -3,7 +3,24 @@
  * Place this file in the main project directory as solve.cpp
  *
  * Usage:
- *   ./solve path/to/file.cnf
+ *   ./solve path/to/file.cnf [--mode <n>] [--heuristic <n>] [--phase <n>] [--restarts <n>] [--regime <n>]
+ *           [--time-limit <s>]
+ *
+ * Options:
+ *   --mode  search engine (sat::SolveMode): 0 = DPLL with restarts, 1 = DPLL with FirstVariable, 2 = CDCL (default),
+ *           3 = DPLL with lookahead branching and failed literal detection (small hard instances),
+ *           4 = ProbSAT local search followed by CDCL from its best assignment (random satisfiable instances)
+ *   --heuristic  branching heuristic of DPLL / CDCL (sat::BranchingHeuristic): 0 = VSIDS (default), 1 = LRB,
+ *                2 = WeightedDegree, 3 = FirstVariable, 4 = Jeroslow-Wang, 5 = MOMs, 6 = DLIS
+ *   --phase  polarity of decisions (sat::PhaseMode): 0 = negative, 1 = positive, 2 = saved phases (default),
+ *            3 = random, 4 = target phases
+ *   --restarts  restart policy of DPLL / CDCL (sat::RestartStrategy): 0 = Luby (default), 1 = geometric,
+ *               2 = Glucose (LBD moving averages with restart blocking), 3 = no restarts
+ *   --regime  search regime of CDCL (sat::SearchRegime): 0 = focused (default), 1 = stable, 2 = alternating focused
+ *             and stable search. Stable and alternating search rephase periodically. Stable search uses its own
+ *             rare Luby restarts and target phases, i.e. it overrides --restarts and --phase (in alternating search
+ *             they only apply to the focused phases)
+ *   --time-limit  wall clock limit in seconds, 0 = no limit (default). Prints "c UNKNOWN" if the limit is reached
  *
  * Output rules:
  * - If UNSAT: print "UNSAT"
@@ -16,9 +33,11 @@
 #include <string>
 #include <vector>
 #include <chrono>
+#include <algorithm>
 
 #include "Solver/Solver.hpp"
 #include "Solver/inout.hpp"
+#include "Solver/util/cli.hpp"
 
 static std::vector<std::vector<sat::Literal>> extractUnitSolution(const sat::Solver &solver) {
     std::vector<std::vector<sat::Literal>> solution;
@@ -29,54 +48,70 @@ static std::vector<std::vector<sat::Literal>> extractUnitSolution(const sat::Sol
 }
 
 int main(int argc, char **argv) {
-    if (argc < 2) {
-        std::cout << "c Usage: " << argv[0] << " path/to/problem.cnf\n";
-        return 1;
-    }
-
-    const std::string cnfFile = argv[1];
+    using namespace sat;
+    SolveMode mode = SolveMode::Cdcl;
+    BranchingHeuristic heuristic = BranchingHeuristic::Vsids;
+    PhaseMode phase = PhaseMode::Saved;
+    RestartStrategy restarts = RestartStrategy::Luby;
+    SearchRegime regime = SearchRegime::Focused;
+    unsigned timeLimit = 0;
+    const std::string cnfFile = cli::parse(argc, argv, cli::ValueArg("--mode", mode),
+                                           cli::ValueArg("--heuristic", heuristic),
+                                           cli::ValueArg("--phase", phase),
+                                           cli::ValueArg("--restarts", restarts),
+                                           cli::ValueArg("--regime", regime),
+                                           cli::ValueArg("--time-limit", timeLimit));
     std::ifstream ifs(cnfFile);
     if (!ifs.is_open()) {
         std::cout << "c Could not open file " << cnfFile << "\n";
         return 1;
     }
 
-    auto [clauses, numVariables] = sat::inout::read_from_dimacs(ifs);
-
-    sat::Solver solverWeighted(numVariables);
-    sat::Solver solverFirst(numVariables);
+    auto [clauses, numVariables] = inout::read_from_dimacs(ifs);
 
+    Solver solver(numVariables);
+    solver.setSolveMode(mode);
+    solver.setHeuristic(heuristic);
+    solver.setPolarity(phase);
+    solver.setRestartPolicy(restarts);
+    solver.setSearchRegime(regime);
+    if (timeLimit > 0) {
+        SolveLimits limits;
+        limits.time = std::chrono::seconds(timeLimit);
+        solver.setLimits(limits);
+    }
     for (auto &cl : clauses) {
-        std::vector<sat::Literal> copy = cl; // keep a copy for solverFirst
-        solverWeighted.addClause(sat::Clause(std::move(cl)));
-        solverFirst.addClause(sat::Clause(std::move(copy)));
+        solver.addClause(Clause(std::move(cl)));
     }
 
     auto t0 = std::chrono::steady_clock::now();
-    bool satWeighted = solverWeighted.solve();
+    const SolveStatus status = solver.solveLimited();
     auto t1 = std::chrono::steady_clock::now();
-    auto msWeighted = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
-
-    auto t2 = std::chrono::steady_clock::now();
-    bool satFirst = solverFirst.solveFirstVariable();
-    auto t3 = std::chrono::steady_clock::now();
-    auto msFirst = std::chrono::duration_cast<std::chrono::milliseconds>(t3 - t2).count();
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
 
     std::cout << "c File: " << cnfFile << "\n";
     std::cout << "c Vars: " << numVariables << "\n";
-    std::cout << "c Time WeightedDegree+Restart: " << msWeighted << " ms\n";
-    std::cout << "c Time FirstVariable: " << msFirst << " ms\n";
+    std::cout << "c Time " << mode << ": " << ms << " ms\n";
+    const auto &stats = solver.getStatistics();
+    std::cout << "c Conflicts: " << stats.conflicts << ", restarts: " << stats.restarts << " (partial: "
+              << stats.partialRestarts << ", reused assignments: " << stats.reusedAssignments << ")\n";
+    std::cout << "c Propagations: " << stats.propagations << " ("
+              << stats.propagations * 1000 / static_cast<std::uint64_t>(std::max<long long>(ms, 1)) << "/s)\n";
+    if (mode == SolveMode::LocalSearch) {
+        std::cout << "c Flips: " << stats.flips << "\n";
+    }
 
-    if (satWeighted != satFirst) {
-        std::cout << "c WARNING: solvers disagree (one says SAT, the other UNSAT)\n";
+    if (status == SolveStatus::Unknown) {
+        std::cout << "c UNKNOWN\n";
+        return 0;
     }
 
-    if (!satWeighted) {
+    if (status == SolveStatus::Unsat) {
         std::cout << "UNSAT\n";
         return 0;
     }
 
-    auto solution = extractUnitSolution(solverWeighted);
-    std::cout << sat::inout::to_dimacs(solution);
+    auto solution = extractUnitSolution(solver);
+    std::cout << inout::to_dimacs(solution);
     return 0;
 }